@@ -3,10 +3,15 @@
 class QLineEdit;
 class QAction;
 class QComboBox;
+class QLabel;
+class QTreeWidget;
 class QLoguru;
 
 class QAbstractLoguruToolBar
 {
+public:
+    static constexpr int defaultMaximumFilterDelay = 300; // milliseconds
+
 public:
     /**
      * @brief Constructor
@@ -81,8 +86,49 @@ public:
      */
     virtual QComboBox* autoScrollPolicy() = 0;
 
+    /**
+     * @brief Get the filter status label.
+     *
+     * The label shows the progress of the filtering of large logs and of the
+     * imports, and why spilling stopped if it did. Toolbars without one
+     * return nullptr.
+     *
+     * @return QLabel* the filter status label
+     */
+    virtual QLabel* filterStatus();
+
+    /**
+     * @brief Get the facet tree.
+     *
+     * The tree lists the levels and the threads with their number of
+     * messages, unchecking one of them hides its messages. Toolbars without
+     * one return nullptr.
+     *
+     * @return QTreeWidget* the facet tree
+     */
+    virtual QTreeWidget* facets();
+
+    /**
+     * @brief Set the longest time applying a filter change can be delayed.
+     *
+     * Changes are applied right away while filtering is fast. Once it gets
+     * slow, they are delayed until the user stops typing, for at most this
+     * long. 0 always applies them right away.
+     *
+     * @param milliseconds the maximum delay
+     */
+    void setMaximumFilterDelay(int milliseconds);
+
+    /**
+     * @brief Get the longest time applying a filter change can be delayed.
+     *
+     * @return int the maximum delay in milliseconds
+     */
+    int getMaximumFilterDelay() const;
+
 private:
     QLoguru* _parent;
+    int _maximumFilterDelay = defaultMaximumFilterDelay;
 };
 
 extern QAbstractLoguruToolBar* createToolBar();
@@ -2,6 +2,9 @@
 
 #include <QFont>
 #include <QWidget>
+#include <vector>
+
+#include "qloguru_style_rule.hpp"
 
 
 class QtLoggerSink;
@@ -9,7 +12,14 @@ class QAbstractLoguruToolBar;
 class QMenu;
 class QLoguruModel;
 class QLoguruProxyModel;
+class QLoguruColumnSizer;
+class QLoguruImporter;
+class QLoguruLogView;
+class QAbstractScrollArea;
+class QHeaderView;
 class QTreeView;
+class QTreeWidget;
+class QTimer;
 
 enum class AutoScrollPolicy {
     AutoScrollPolicyDisabled =
@@ -21,6 +31,15 @@ enum class AutoScrollPolicy {
            // before inserting the new ones.
 };
 
+enum class OverflowPolicy {
+    OverflowPolicyDropNewest =
+        0, // Discard the incoming message when the buffer is full.
+    OverflowPolicyDropOldest =
+        1, // Discard the oldest buffered message to make room for the new one.
+    OverflowPolicyBlock = 2, // Make the logging thread wait until the widget
+                             // drains the buffer (bounded wait).
+};
+
 class QLoguru : public QWidget
 {
 public:
@@ -90,6 +109,105 @@ public:
      */
     std::optional<std::size_t> getMaxEntries() const;
 
+    /**
+     * @brief Save the messages to a capture file.
+     *
+     * The capture is a compressed binary file holding every message of the
+     * widget, including the ones filtered out. An existing file is only
+     * replaced once the capture is complete.
+     *
+     * @param path the path of the capture file
+     * @return bool whether the capture was saved
+     */
+    bool saveCapture(const QString& path) const;
+
+    /**
+     * @brief Load the messages of a capture file.
+     *
+     * The messages of the capture replace the ones of the widget, limited to
+     * the most recent ones by the maximum number of entries. The logger
+     * styles and the style rules apply to them as to logged messages.
+     *
+     * @param path the path of the capture file
+     * @return bool false if the file couldn't be read, the messages read up
+     * to the error are kept
+     */
+    bool loadCapture(const QString& path);
+
+    /**
+     * @brief Import a log file written by loguru.
+     *
+     * The messages of the file are appended to the widget as they're parsed,
+     * in the background, the first ones show up before the whole file is
+     * read. The toolbars show the progress. Starting an import cancels the
+     * one in progress.
+     *
+     * @param path the path of the log file, as given to loguru::add_file
+     * @return bool false if the file couldn't be opened
+     */
+    bool importLogFile(const QString& path);
+
+    /**
+     * @brief Stop the import in progress.
+     *
+     * The messages already imported are kept.
+     */
+    void cancelImport();
+
+    /**
+     * @brief Check whether a log file is being imported.
+     *
+     * @return bool whether a log file is being imported
+     */
+    bool isImporting() const;
+
+    /**
+     * @brief Set the directory the older messages are spilled to.
+     *
+     * Without a spill directory every message is kept in memory until it's
+     * removed by the maximum number of entries. With one, only the most
+     * recent messages stay in memory, the older ones are moved to temporary
+     * memory-mapped files in the directory, which are removed along with
+     * their messages. The messages on disk are shown and filtered like the
+     * others. Their level and logger indexes stay in memory, a few bits per
+     * message, as do the results of the style rules, two bytes per message
+     * while there are rules.
+     *
+     * If a file can't be written to the directory, spilling stops and the
+     * messages stay in memory from then on. The status of the toolbars says
+     * so until another directory is set.
+     *
+     * @param directory the spill directory, empty to stop spilling
+     */
+    void setSpillDirectory(const QString& directory);
+
+    /**
+     * @brief Get the directory the older messages are spilled to.
+     *
+     * @return QString the spill directory, empty if not spilling or if
+     * spilling failed
+     */
+    QString getSpillDirectory() const;
+
+    /**
+     * @brief Set the number of most recent messages kept in memory while
+     * spilling.
+     *
+     * Messages are spilled in batches written in the background, up to two
+     * batches more may be in memory.
+     *
+     * @param count the number of messages kept in memory
+     */
+    void setMemoryEntries(std::size_t count);
+
+    /**
+     * @brief Get the number of most recent messages kept in memory while
+     * spilling.
+     *
+     * @return std::size_t the number of messages kept in memory
+     */
+    std::size_t getMemoryEntries() const;
+
     /**
      * @brief Set the foreground QBrush for the messages of the corresponding
      * logger.
@@ -154,6 +272,24 @@ public:
      */
     std::optional<QFont> getLoggerFont(std::string_view loggerName) const;
 
+    /**
+     * @brief Set the style rules.
+     *
+     * The rules are evaluated once for every message, when it's logged or
+     * when the rules change, and take precedence over the logger styles.
+     * Rules whose condition isn't valid match no message.
+     *
+     * @param rules the rules, the first one a message matches applies
+     */
+    void setStyleRules(std::vector<QLoguruStyleRule> rules);
+
+    /**
+     * @brief Get the style rules.
+     *
+     * @return const std::vector<QLoguruStyleRule>& the rules
+     */
+    const std::vector<QLoguruStyleRule>& getStyleRules() const;
+
     /**
      * @brief Set the policy of the auto-scrolling feature.
      *
@@ -164,18 +300,166 @@ public:
      */
     void setAutoScrollPolicy(AutoScrollPolicy policy);
 
+    /**
+     * @brief Resolve the level names again.
+     *
+     * The names are resolved once per level. Call this after registering a
+     * different callback with loguru::set_verbosity_to_name_callback.
+     */
+    void refreshLevelNames();
+
+    /**
+     * @brief Set the capacity of the ingestion buffer.
+     *
+     * Messages coming from the logging threads are queued in a bounded buffer
+     * which is drained by the GUI thread. The capacity is rounded up to the
+     * next power of two. Messages still in the old buffer are flushed into
+     * the widget before it is replaced.
+     *
+     * @param capacity the capacity of the buffer
+     */
+    void setBufferCapacity(std::size_t capacity);
+
+    /**
+     * @brief Get the capacity of the ingestion buffer.
+     *
+     * @return std::size_t the capacity of the buffer
+     */
+    std::size_t getBufferCapacity() const;
+
+    /**
+     * @brief Set the policy applied when the ingestion buffer is full.
+     *
+     * @param policy the overflow policy
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+
+    /**
+     * @brief Get the policy applied when the ingestion buffer is full.
+     *
+     * @return OverflowPolicy the overflow policy
+     */
+    OverflowPolicy getOverflowPolicy() const;
+
+    /**
+     * @brief Get the number of messages dropped by the ingestion buffer.
+     *
+     * @return std::size_t the number of dropped messages
+     */
+    std::size_t droppedCount() const;
+
+    /**
+     * @brief Get the highest number of messages that were waiting in the
+     * ingestion buffer at once.
+     *
+     * @return std::size_t the high-water mark of the buffer
+     */
+    std::size_t highWaterMark() const;
+
+    /**
+     * @brief Enable or disable the search index.
+     *
+     * The index keeps track of the trigrams of the messages, filters with a
+     * literal text then only check the rows which may contain it. It's meant
+     * for very large logs and costs memory, so it's disabled by default.
+     *
+     * @param enabled whether the index is enabled
+     */
+    void setSearchIndexEnabled(bool enabled);
+
+    /**
+     * @brief Check whether the search index is enabled.
+     *
+     * @return bool whether the index is enabled
+     */
+    bool isSearchIndexEnabled() const;
+
+    /**
+     * @brief Set the memory limit of the search index.
+     *
+     * Once the index grows past the limit it stops covering the older half of
+     * the messages, these are searched without its help.
+     *
+     * @param memoryLimit the limit in bytes
+     */
+    void setSearchIndexMemoryLimit(std::size_t memoryLimit);
+
+    /**
+     * @brief Get the memory limit of the search index.
+     *
+     * @return std::size_t the limit in bytes
+     */
+    std::size_t getSearchIndexMemoryLimit() const;
+
+    /**
+     * @brief Show the messages in the lightweight view.
+     *
+     * The lightweight view only handles flat logs with rows of the same
+     * height, which lets it paint the visible rows only and keep their text
+     * laid out, however many messages there are. The columns shown and their
+     * sizes carry over from one view to the other.
+     *
+     * @param enabled whether the lightweight view is shown instead of the
+     * tree view
+     */
+    void setLightweightViewEnabled(bool enabled);
+
+    /**
+     * @brief Check whether the lightweight view is shown.
+     *
+     * @return bool whether the lightweight view is shown
+     */
+    bool isLightweightViewEnabled() const;
+
+    /**
+     * @brief Enable or disable the performance mode of the tree view.
+     *
+     * In performance mode all the rows have the same height and the columns
+     * are sized to their contents from a sample of the rows as they arrive,
+     * rather than by measuring the rows one by one.
+     *
+     * @param enabled whether the performance mode is enabled
+     */
+    void setPerformanceModeEnabled(bool enabled);
+
+    /**
+     * @brief Check whether the performance mode of the tree view is enabled.
+     *
+     * @return bool whether the performance mode is enabled
+     */
+    bool isPerformanceModeEnabled() const;
+
 private slots:
-    void filterData(
+    // Returns false if the filter is invalid, the current one stays.
+    bool filterData(
         const QString& text, bool isRegularExpression, bool isCaseSensitive
     );
     void updateAutoScrollPolicy(int index);
+    void autoScroll();
+    void updateFacets();
+
+private:
+    void setupHeader(QHeaderView* header);
+    QAbstractScrollArea* currentView() const;
+    void scrollToBottom();
+    void updateFacets(QTreeWidget* tree);
+    void applyFacets(QTreeWidget* tree);
+    void setSpillError(const QString& error);
 
 private:
     QLoguruModel* _sourceModel;
     QLoguruProxyModel* _proxyModel;
     QTreeView* _view;
-    bool _scrollIsAtBottom;
-    QMetaObject::Connection _scrollConnection;
+    QLoguruLogView* _logView = nullptr;
+    bool _scrollIsAtBottom = false;
+    AutoScrollPolicy _autoScrollPolicy =
+        AutoScrollPolicy::AutoScrollPolicyDisabled;
     std::shared_ptr<QtLoggerSink> _sink;
     std::list<QAbstractLoguruToolBar*> _toolbars;
+    QTimer* _facetTimer;
+    QTimer* _scrollTimer;
+    QLoguruColumnSizer* _columnSizer;
+    QLoguruImporter* _importer;
+    // Shown by the status of the toolbars while there's no progress to show.
+    QString _spillError;
 };
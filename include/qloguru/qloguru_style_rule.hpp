@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QString>
+#include <optional>
+
+/**
+ * Style of the messages matching a condition.
+ *
+ * The condition is written like the filter of the toolbar, e.g.
+ * "level>=error" or "msg:deadline". A message takes the style of the first
+ * rule it matches, the style of its logger fills in what the rule leaves
+ * unset.
+ */
+struct QLoguruStyleRule {
+    QString condition;
+    std::optional<QBrush> background;
+    std::optional<QColor> foreground;
+    std::optional<QFont> font;
+
+    bool operator==(const QLoguruStyleRule& other) const = default;
+};
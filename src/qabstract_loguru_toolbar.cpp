@@ -10,3 +10,17 @@ QAbstractLoguruToolBar::~QAbstractLoguruToolBar()
 }
 
 void QAbstractLoguruToolBar::setParent(QLoguru* parent) { _parent = parent; }
+
+QLabel* QAbstractLoguruToolBar::filterStatus() { return nullptr; }
+
+QTreeWidget* QAbstractLoguruToolBar::facets() { return nullptr; }
+
+void QAbstractLoguruToolBar::setMaximumFilterDelay(int milliseconds)
+{
+    _maximumFilterDelay = milliseconds;
+}
+
+int QAbstractLoguruToolBar::getMaximumFilterDelay() const
+{
+    return _maximumFilterDelay;
+}
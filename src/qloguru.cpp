@@ -1,76 +1,104 @@
 #include <QAction>
 #include <QComboBox>
+#include <QDir>
 #include <QHBoxLayout>
 #include <QHeaderView>
+#include <QLabel>
 #include <QLineEdit>
 #include <QMenu>
 #include <QScrollBar>
+#include <QSignalBlocker>
+#include <QTimer>
 #include <QTreeView>
+#include <QTreeWidget>
+#include <algorithm>
 
 #include "qloguru/qloguru.hpp"
 
 #include "qloguru/qabstract_loguru_toolbar.hpp"
+#include "qloguru_column_sizer.hpp"
+#include "qloguru_filter_scheduler.hpp"
+#include "qloguru_importer.hpp"
+#include "qloguru_log_view.hpp"
 #include "qloguru_model.hpp"
 #include "qloguru_proxy_model.hpp"
 #include "qloguru_style_dialog.hpp"
 #include "qt_logger_sink_loguru.hpp"
 
+namespace
+{
+
+static constexpr int facetRefreshInterval = 500; // milliseconds
+static constexpr int scrollInterval = 16;        // milliseconds, a frame
+static constexpr int facetRole = Qt::UserRole;
+
+} // namespace
+
 QLoguru::QLoguru(QWidget* parent)
     : QWidget(parent)
     , _sourceModel(new QLoguruModel)
     , _proxyModel(new QLoguruProxyModel)
     , _view(new QTreeView)
+    , _facetTimer(new QTimer(this))
+    , _scrollTimer(new QTimer(this))
+    , _columnSizer(new QLoguruColumnSizer(_view, _proxyModel, this))
+    , _importer(new QLoguruImporter(_sourceModel, this))
 {
     Q_INIT_RESOURCE(qloguru_resources);
     _view->setModel(_proxyModel);
     _view->setObjectName("qloguruTreeView");
 
-    QHeaderView* header = _view->header();
-    header->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(
-        header,
-        &QHeaderView::customContextMenuRequested,
-        this,
-        [ this, header ](const QPoint& pos) {
-        QMenu contextMenu;
-        contextMenu.setObjectName("qloguruHeaderContextMenu");
-        for (int i = 0; i < _sourceModel->columnCount(); ++i) {
-            QString columnHeader =
-                _sourceModel->headerData(i, Qt::Horizontal).toString();
-            QAction* action = contextMenu.addAction(columnHeader);
-            action->setCheckable(true);
-            action->setChecked(!header->isSectionHidden(i));
-            action->setData(i);
-
-            connect(
-                action,
-                &QAction::toggled,
-                this,
-                [ this, header ](bool checked) {
-                QAction* action = qobject_cast<QAction*>(sender());
-                if (action)
-                    header->setSectionHidden(action->data().toInt(), !checked);
-                });
-        }
-
-        contextMenu.exec(header->mapToGlobal(pos));
-        });
+    setupHeader(_view->header());
 
     _proxyModel->setSourceModel(_sourceModel);
 
+    // Scrolling follows the frames rather than the insertions, whatever the
+    // rate of the messages. The position of the scrollbar is checked before
+    // the first insertion of a frame, once the rows are inserted it may not be
+    // at the bottom anymore.
+    _scrollTimer->setSingleShot(true);
+    _scrollTimer->setInterval(scrollInterval);
+    connect(_scrollTimer, &QTimer::timeout, this, &QLoguru::autoScroll);
     connect(
         _sourceModel,
         &QAbstractItemModel::rowsAboutToBeInserted,
         this,
-        [ this ](const QModelIndex& parent, int first, int last) {
-        auto bar = _view->verticalScrollBar();
+        [ this ]() {
+        if (_autoScrollPolicy == AutoScrollPolicy::AutoScrollPolicyDisabled ||
+            _scrollTimer->isActive())
+            return;
+
+        auto bar = currentView()->verticalScrollBar();
         _scrollIsAtBottom = bar ? (bar->value() == bar->maximum()) : false;
+        _scrollTimer->start();
         });
 
     _view->setRootIsDecorated(false);
 
     _sink = std::make_shared<QtLoggerSink>(_sourceModel);
 
+    connect(
+        _sourceModel,
+        &QLoguruModel::spillFailed,
+        this,
+        [ this ](const QString& directory) {
+            setSpillError(
+                QString("Can't spill to %1, keeping messages in memory")
+                    .arg(QDir::toNativeSeparators(directory))
+            );
+        }
+    );
+
+    // The facet counts are refreshed periodically rather than on every
+    // insertion, only while a facet tree is shown.
+    _facetTimer->setInterval(facetRefreshInterval);
+    connect(
+        _facetTimer,
+        &QTimer::timeout,
+        this,
+        static_cast<void (QLoguru::*)()>(&QLoguru::updateFacets)
+    );
+
     setLayout(new QHBoxLayout);
     layout()->setContentsMargins(0, 0, 0, 0);
     layout()->addWidget(_view);
@@ -93,10 +121,44 @@ void QLoguru::registerToolbar(QAbstractLoguruToolBar* toolbarInterface)
     QAction* style = toolbarInterface->style();
     QComboBox* autoScrollPolicyCombo = toolbarInterface->autoScrollPolicy();
 
-    auto updateFilter = [ this, filter, regex, caseSensitive ]() {
-        filterData(
-            filter->text(), regex->isChecked(), caseSensitive->isChecked()
-        );
+    // Owned by the widget rather than the toolbar, custom toolbars don't
+    // have to be QObjects.
+    auto scheduler = new QLoguruFilterScheduler(
+        [ this ](const QLoguruFilterScheduler::settings_t& settings) {
+            using Result = QLoguruFilterScheduler::Result;
+            if (!filterData(
+                    settings.text,
+                    settings.isRegularExpression,
+                    settings.isCaseSensitive
+                ))
+                return Result::Rejected;
+            return _proxyModel->isFiltering() ? Result::Running
+                                              : Result::Applied;
+        },
+        this
+    );
+    // Large models are filtered in the background, the cost of a filter is
+    // only known once its scan is done.
+    connect(
+        _proxyModel,
+        &QLoguruProxyModel::filterProgress,
+        scheduler,
+        [ scheduler ](qint64 scanned, qint64 total) {
+            if (scanned >= total)
+                scheduler->finished();
+        }
+    );
+
+    auto updateFilter = [ this, toolbarInterface, scheduler, filter, regex,
+                          caseSensitive ]() {
+        // The toolbar may be gone while its widgets are still around.
+        auto it = std::find(_toolbars.begin(), _toolbars.end(), toolbarInterface);
+        if (it != _toolbars.end())
+            scheduler->setMaximumDelay((*it)->getMaximumFilterDelay());
+
+        scheduler->schedule({ filter->text(),
+                              regex->isChecked(),
+                              caseSensitive->isChecked() });
     };
 
     connect(filter, &QLineEdit::textChanged, this, updateFilter);
@@ -111,15 +173,39 @@ void QLoguru::registerToolbar(QAbstractLoguruToolBar* toolbarInterface)
 
         QLoguruStyleDialog::Style value = dialog.result();
 
-        _sourceModel->setLoggerBackground(
-            value.loggerName, value.backgroundColor
-        );
-
-        _sourceModel->setLoggerForeground(value.loggerName, value.textColor);
-
         QFont f;
         f.setBold(value.fontBold);
-        _sourceModel->setLoggerFont(value.loggerName, f);
+        if (value.condition.isEmpty()) {
+            _sourceModel->setLoggerStyle(
+                value.loggerName, value.backgroundColor, value.textColor, f
+            );
+            return;
+        }
+
+        // The rule of the condition is replaced, or removed if there's no
+        // style left.
+        std::vector<QLoguruStyleRule> rules = _sourceModel->getStyleRules();
+        auto it = std::find_if(
+            rules.begin(),
+            rules.end(),
+            [ & ](const QLoguruStyleRule& rule) {
+            return rule.condition == value.condition;
+            }
+        );
+        QLoguruStyleRule rule {
+            value.condition,
+            value.backgroundColor,
+            value.textColor,
+            value.fontBold ? std::optional<QFont>(f) : std::nullopt
+        };
+        bool isEmpty = !rule.background && !rule.foreground && !rule.font;
+        if (it == rules.end() && !isEmpty)
+            rules.push_back(std::move(rule));
+        else if (it != rules.end() && isEmpty)
+            rules.erase(it);
+        else if (it != rules.end())
+            *it = std::move(rule);
+        _sourceModel->setStyleRules(std::move(rules));
     });
     connect(
         autoScrollPolicyCombo,
@@ -127,6 +213,42 @@ void QLoguru::registerToolbar(QAbstractLoguruToolBar* toolbarInterface)
         this,
         &QLoguru::updateAutoScrollPolicy
     );
+
+    if (QLabel* status = toolbarInterface->filterStatus()) {
+        status->setText(_spillError);
+        connect(
+            _proxyModel,
+            &QLoguruProxyModel::filterProgress,
+            status,
+            [ this, status ](qint64 scanned, qint64 total) {
+                if (scanned >= total)
+                    status->setText(_spillError);
+                else
+                    status->setText(QString("%1/%2").arg(scanned).arg(total));
+            }
+        );
+        connect(
+            _importer,
+            &QLoguruImporter::importProgress,
+            status,
+            [ this, status ](qint64 read, qint64 total) {
+                if (read >= total)
+                    status->setText(_spillError);
+                else
+                    status->setText(
+                        QString("Importing %1%").arg(read * 100 / total)
+                    );
+            }
+        );
+    }
+
+    if (QTreeWidget* tree = toolbarInterface->facets()) {
+        updateFacets(tree);
+        connect(tree, &QTreeWidget::itemChanged, this, [ this, tree ]() {
+            applyFacets(tree);
+        });
+        _facetTimer->start();
+    }
 }
 
 void QLoguru::removeToolbar(QAbstractLoguruToolBar* toolbarInterface)
@@ -137,65 +259,243 @@ void QLoguru::removeToolbar(QAbstractLoguruToolBar* toolbarInterface)
     );
 }
 
-void QLoguru::filterData(
-    const QString& text, bool isRegularExpression, bool isCaseSensitive
-)
+void QLoguru::setupHeader(QHeaderView* header)
 {
-    _proxyModel->setFilterCaseSensitivity(
-        isCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive
-    );
+    header->setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(
+        header,
+        &QHeaderView::customContextMenuRequested,
+        this,
+        [ this, header ](const QPoint& pos) {
+        QMenu contextMenu;
+        contextMenu.setObjectName("qloguruHeaderContextMenu");
+        for (int i = 0; i < _sourceModel->columnCount(); ++i) {
+            QString columnHeader =
+                _sourceModel->headerData(i, Qt::Horizontal).toString();
+            QAction* action = contextMenu.addAction(columnHeader);
+            action->setCheckable(true);
+            action->setChecked(!header->isSectionHidden(i));
+            action->setData(i);
+
+            connect(
+                action,
+                &QAction::toggled,
+                this,
+                [ this, header ](bool checked) {
+                QAction* action = qobject_cast<QAction*>(sender());
+                if (action)
+                    header->setSectionHidden(action->data().toInt(), !checked);
+                });
+        }
 
-    if (isRegularExpression) {
-        QRegularExpression regex(text);
+        contextMenu.exec(header->mapToGlobal(pos));
+        });
+}
 
-        if (!regex.isValid())
-            return;
+QAbstractScrollArea* QLoguru::currentView() const
+{
+    if (isLightweightViewEnabled())
+        return _logView;
 
-        _proxyModel->setFilterRegularExpression(text);
-    } else {
-        _proxyModel->setFilterFixedString(text);
+    return _view;
+}
+
+void QLoguru::scrollToBottom()
+{
+    if (isLightweightViewEnabled())
+        _logView->scrollToBottom();
+    else
+        _view->scrollToBottom();
+}
+
+void QLoguru::updateFacets()
+{
+    for (QAbstractLoguruToolBar* toolbar : _toolbars) {
+        QTreeWidget* tree = toolbar->facets();
+        if (tree && tree->isVisible())
+            updateFacets(tree);
     }
 }
 
-void QLoguru::setAutoScrollPolicy(AutoScrollPolicy policy)
+void QLoguru::updateFacets(QTreeWidget* tree)
 {
-    QObject::disconnect(_scrollConnection);
+    // Only the user toggling an item is a change of the facets.
+    QSignalBlocker blocker(tree);
 
-    switch (policy) {
-        case AutoScrollPolicy::AutoScrollPolicyEnabled: {
-            _scrollConnection = connect(
-                _sourceModel,
-                &QLoguruModel::rowsInserted,
-                _view,
-                &QTreeView::scrollToBottom
+    if (tree->topLevelItemCount() == 0) {
+        tree->addTopLevelItem(new QTreeWidgetItem({ "Levels" }));
+        tree->addTopLevelItem(new QTreeWidgetItem({ "Threads" }));
+        tree->expandAll();
+    }
+
+    const QLoguruFacetIndex& index = _sourceModel->facetIndex();
+    const QLoguruProxyModel::Facets& facets = _proxyModel->facets();
+
+    // Facets appear once they have messages and then stay, so they don't
+    // jump around while the log scrolls.
+    QTreeWidgetItem* levels = tree->topLevelItem(0);
+    for (int level = QLoguruLevels::minLevel; level <= QLoguruLevels::maxLevel;
+         ++level) {
+        std::size_t count = index.level(level).cardinality();
+
+        int position = 0;
+        while (position < levels->childCount() &&
+               levels->child(position)->data(0, facetRole).toInt() < level)
+            ++position;
+
+        QTreeWidgetItem* item = levels->child(position);
+        if (!item || item->data(0, facetRole).toInt() != level) {
+            if (count == 0)
+                continue;
+
+            item = new QTreeWidgetItem({ _sourceModel->levels().name(level) });
+            item->setData(0, facetRole, level);
+            item->setCheckState(
+                0,
+                facets.hiddenLevels[ QLoguruLevels::index(level) ]
+                    ? Qt::Unchecked
+                    : Qt::Checked
             );
-            break;
+            levels->insertChild(position, item);
         }
+        item->setText(1, QString::number(count));
+    }
 
-        case AutoScrollPolicy::AutoScrollPolicyEnabledIfBottom: {
-            _scrollConnection = connect(
-                _sourceModel,
-                &QLoguruModel::rowsInserted,
-                this,
-                [ this ]() {
-                // We can't check if the scrollbar is at the bottom here because
-                // the new rows are already inserted and the position of the
-                // scrollbar may not be at the bottom of the widget anymore.
-                // That's why the scroll position is checked before actually
-                // adding the rows (AKA in the rowsAboutToBeInserted signal).
-                if (_scrollIsAtBottom)
-                    _view->scrollToBottom();
-                });
-            break;
+    QTreeWidgetItem* threads = tree->topLevelItem(1);
+    const QLoguruStringTable& names = _sourceModel->storage().loggerNames();
+    for (std::uint32_t id = 0; id < names.size(); ++id) {
+        const QLoguruBitmap* rows = index.logger(id);
+        std::size_t count = rows ? rows->cardinality() : 0;
+        QString name = QString::fromStdString(std::string(names[ id ]));
+
+        QTreeWidgetItem* item = nullptr;
+        for (int i = 0; i < threads->childCount() && !item; ++i) {
+            if (threads->child(i)->data(0, facetRole).toString() == name)
+                item = threads->child(i);
         }
 
-        default: {
-            // The connection is already disconnected. No need for handling the
-            // AutoScrollPolicyDisabled case.
-            break;
+        if (!item) {
+            if (count == 0)
+                continue;
+
+            item = new QTreeWidgetItem({ name });
+            item->setData(0, facetRole, name);
+            bool hidden = std::find(
+                              facets.hiddenLoggers.begin(),
+                              facets.hiddenLoggers.end(),
+                              names[ id ]
+                          ) != facets.hiddenLoggers.end();
+            item->setCheckState(0, hidden ? Qt::Unchecked : Qt::Checked);
+            threads->addChild(item);
         }
+        item->setText(1, QString::number(count));
+    }
+}
+
+void QLoguru::applyFacets(QTreeWidget* tree)
+{
+    QLoguruProxyModel::Facets facets;
+
+    QTreeWidgetItem* levels = tree->topLevelItem(0);
+    for (int i = 0; i < levels->childCount(); ++i) {
+        QTreeWidgetItem* item = levels->child(i);
+        int level = item->data(0, facetRole).toInt();
+        facets.hiddenLevels[ QLoguruLevels::index(level) ] =
+            item->checkState(0) == Qt::Unchecked;
     }
 
+    QTreeWidgetItem* threads = tree->topLevelItem(1);
+    for (int i = 0; i < threads->childCount(); ++i) {
+        QTreeWidgetItem* item = threads->child(i);
+        if (item->checkState(0) == Qt::Unchecked) {
+            facets.hiddenLoggers.push_back(
+                item->data(0, facetRole).toString().toStdString()
+            );
+        }
+    }
+
+    _proxyModel->setFacets(std::move(facets));
+}
+
+bool QLoguru::filterData(
+    const QString& text, bool isRegularExpression, bool isCaseSensitive
+)
+{
+    QLoguruFilter filter(text, isRegularExpression, isCaseSensitive);
+
+    if (!filter.isValid())
+        return false;
+
+    _proxyModel->setFilter(std::move(filter));
+    return true;
+}
+
+void QLoguru::refreshLevelNames() { _sourceModel->refreshLevelNames(); }
+
+void QLoguru::setBufferCapacity(std::size_t capacity)
+{
+    OverflowPolicy policy = _sink->buffer().policy();
+
+    // Stop the old sink first and flush what it already received, so no
+    // message is lost or delivered twice while swapping the buffers.
+    _sink->detach();
+    _sink->drain();
+
+    _sink = std::make_shared<QtLoggerSink>(_sourceModel, capacity);
+    _sink->buffer().setPolicy(policy);
+}
+
+std::size_t QLoguru::getBufferCapacity() const
+{
+    return _sink->buffer().capacity();
+}
+
+void QLoguru::setOverflowPolicy(OverflowPolicy policy)
+{
+    _sink->buffer().setPolicy(policy);
+}
+
+OverflowPolicy QLoguru::getOverflowPolicy() const
+{
+    return _sink->buffer().policy();
+}
+
+std::size_t QLoguru::droppedCount() const
+{
+    return _sink->buffer().droppedCount();
+}
+
+std::size_t QLoguru::highWaterMark() const
+{
+    return _sink->buffer().highWaterMark();
+}
+
+void QLoguru::setSearchIndexEnabled(bool enabled)
+{
+    _sourceModel->setSearchIndexEnabled(enabled);
+}
+
+bool QLoguru::isSearchIndexEnabled() const
+{
+    return _sourceModel->isSearchIndexEnabled();
+}
+
+void QLoguru::setSearchIndexMemoryLimit(std::size_t memoryLimit)
+{
+    _sourceModel->setSearchIndexMemoryLimit(memoryLimit);
+}
+
+std::size_t QLoguru::getSearchIndexMemoryLimit() const
+{
+    return _sourceModel->getSearchIndexMemoryLimit();
+}
+
+void QLoguru::setAutoScrollPolicy(AutoScrollPolicy policy)
+{
+    _autoScrollPolicy = policy;
+    if (policy == AutoScrollPolicy::AutoScrollPolicyDisabled)
+        _scrollTimer->stop();
+
     for (auto& toolbar : _toolbars) {
         QComboBox* policyComboBox = toolbar->autoScrollPolicy();
         if (!policyComboBox)
@@ -207,6 +507,73 @@ void QLoguru::setAutoScrollPolicy(AutoScrollPolicy policy)
     }
 }
 
+void QLoguru::autoScroll()
+{
+    switch (_autoScrollPolicy) {
+        case AutoScrollPolicy::AutoScrollPolicyEnabled: {
+            scrollToBottom();
+            break;
+        }
+
+        case AutoScrollPolicy::AutoScrollPolicyEnabledIfBottom: {
+            if (_scrollIsAtBottom)
+                scrollToBottom();
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+}
+
+void QLoguru::setLightweightViewEnabled(bool enabled)
+{
+    if (enabled == isLightweightViewEnabled())
+        return;
+
+    if (!_logView) {
+        _logView = new QLoguruLogView;
+        _logView->setObjectName("qloguruLogView");
+        _logView->hide();
+        setupHeader(_logView->header());
+        layout()->addWidget(_logView);
+    }
+
+    // Only the shown view follows the model, the columns move over.
+    QHeaderView* from = enabled ? _view->header() : _logView->header();
+    QByteArray columns = from->saveState();
+
+    if (enabled) {
+        _view->setModel(nullptr);
+        _logView->setModel(_proxyModel);
+        _logView->header()->restoreState(columns);
+    } else {
+        _logView->setModel(nullptr);
+        _view->setModel(_proxyModel);
+        _view->header()->restoreState(columns);
+    }
+
+    _view->setVisible(!enabled);
+    _logView->setVisible(enabled);
+}
+
+bool QLoguru::isLightweightViewEnabled() const
+{
+    return _logView && !_logView->isHidden();
+}
+
+void QLoguru::setPerformanceModeEnabled(bool enabled)
+{
+    _view->setUniformRowHeights(enabled);
+    _columnSizer->setEnabled(enabled);
+}
+
+bool QLoguru::isPerformanceModeEnabled() const
+{
+    return _columnSizer->isEnabled();
+}
+
 void QLoguru::updateAutoScrollPolicy(int index)
 {
     AutoScrollPolicy policy = static_cast<AutoScrollPolicy>(index);
@@ -228,6 +595,56 @@ std::optional<std::size_t> QLoguru::getMaxEntries() const
     return _sourceModel->getMaxEntries();
 }
 
+bool QLoguru::saveCapture(const QString& path) const
+{
+    return _sourceModel->saveCapture(path);
+}
+
+bool QLoguru::loadCapture(const QString& path)
+{
+    return _sourceModel->loadCapture(path);
+}
+
+bool QLoguru::importLogFile(const QString& path)
+{
+    return _importer->start(path);
+}
+
+void QLoguru::cancelImport() { _importer->cancel(); }
+
+bool QLoguru::isImporting() const { return _importer->isImporting(); }
+
+void QLoguru::setSpillDirectory(const QString& directory)
+{
+    _sourceModel->setSpillDirectory(directory);
+    if (!_spillError.isEmpty())
+        setSpillError(QString());
+}
+
+void QLoguru::setSpillError(const QString& error)
+{
+    _spillError = error;
+    for (QAbstractLoguruToolBar* toolbar : _toolbars) {
+        if (QLabel* status = toolbar->filterStatus())
+            status->setText(error);
+    }
+}
+
+QString QLoguru::getSpillDirectory() const
+{
+    return _sourceModel->getSpillDirectory();
+}
+
+void QLoguru::setMemoryEntries(std::size_t count)
+{
+    _sourceModel->setMemoryEntries(count);
+}
+
+std::size_t QLoguru::getMemoryEntries() const
+{
+    return _sourceModel->getMemoryEntries();
+}
+
 void QLoguru::setLoggerForeground(
     std::string_view loggerName, std::optional<QColor> brush
 )
@@ -264,4 +681,14 @@ void QLoguru::setLoggerFont(
 std::optional<QFont> QLoguru::getLoggerFont(std::string_view loggerName) const
 {
     return _sourceModel->getLoggerFont(loggerName);
+}
+
+void QLoguru::setStyleRules(std::vector<QLoguruStyleRule> rules)
+{
+    _sourceModel->setStyleRules(std::move(rules));
+}
+
+const std::vector<QLoguruStyleRule>& QLoguru::getStyleRules() const
+{
+    return _sourceModel->getStyleRules();
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <iterator>
+
+#include "qloguru_bitmap.hpp"
+
+void QLoguruBitmap::add(std::uint64_t id)
+{
+    std::uint64_t key = id >> 16;
+    if (_containers.empty() || _containers.back().key != key)
+        _containers.push_back({ key });
+
+    _containers.back().add(static_cast<std::uint16_t>(id));
+    ++_cardinality;
+}
+
+void QLoguruBitmap::removeBefore(std::uint64_t id)
+{
+    std::uint64_t key = id >> 16;
+    while (!_containers.empty() && _containers.front().key < key) {
+        _cardinality -= _containers.front().cardinality;
+        _containers.pop_front();
+    }
+
+    if (_containers.empty() || _containers.front().key != key)
+        return;
+
+    container_t& front = _containers.front();
+    _cardinality -= front.cardinality;
+    front.removeBefore(static_cast<std::uint16_t>(id));
+    _cardinality += front.cardinality;
+    if (front.cardinality == 0)
+        _containers.pop_front();
+}
+
+void QLoguruBitmap::clear()
+{
+    _containers.clear();
+    _cardinality = 0;
+}
+
+bool QLoguruBitmap::contains(std::uint64_t id) const
+{
+    std::uint64_t key = id >> 16;
+    auto it = std::lower_bound(
+        _containers.begin(),
+        _containers.end(),
+        key,
+        [](const container_t& container, std::uint64_t key) {
+            return container.key < key;
+        }
+    );
+    return it != _containers.end() && it->key == key &&
+           it->contains(static_cast<std::uint16_t>(id));
+}
+
+QLoguruBitmap QLoguruBitmap::operator&(const QLoguruBitmap& other) const
+{
+    QLoguruBitmap result;
+    auto a = _containers.begin();
+    auto b = other._containers.begin();
+    while (a != _containers.end() && b != other._containers.end()) {
+        if (a->key < b->key)
+            ++a;
+        else if (b->key < a->key)
+            ++b;
+        else
+            result.push(intersect(*a++, *b++));
+    }
+    return result;
+}
+
+QLoguruBitmap QLoguruBitmap::operator|(const QLoguruBitmap& other) const
+{
+    QLoguruBitmap result;
+    auto a = _containers.begin();
+    auto b = other._containers.begin();
+    while (a != _containers.end() || b != other._containers.end()) {
+        if (b == other._containers.end() ||
+            (a != _containers.end() && a->key < b->key))
+            result.push(container_t(*a++));
+        else if (a == _containers.end() || b->key < a->key)
+            result.push(container_t(*b++));
+        else
+            result.push(unite(*a++, *b++));
+    }
+    return result;
+}
+
+std::size_t QLoguruBitmap::memoryUsage() const
+{
+    std::size_t result = 0;
+    for (const container_t& container : _containers)
+        result += sizeof(container_t) +
+                  container.array.capacity() * sizeof(std::uint16_t) +
+                  container.bits.capacity() * sizeof(std::uint64_t);
+    return result;
+}
+
+QLoguruBitmap::container_t
+QLoguruBitmap::intersect(const container_t& a, const container_t& b)
+{
+    container_t result { a.key };
+    if (!a.isBitset() && !b.isBitset()) {
+        std::set_intersection(
+            a.array.begin(),
+            a.array.end(),
+            b.array.begin(),
+            b.array.end(),
+            std::back_inserter(result.array)
+        );
+    } else if (!a.isBitset() || !b.isBitset()) {
+        const container_t& array = a.isBitset() ? b : a;
+        const container_t& bitset = a.isBitset() ? a : b;
+        std::copy_if(
+            array.array.begin(),
+            array.array.end(),
+            std::back_inserter(result.array),
+            [ & ](std::uint16_t low) { return bitset.contains(low); }
+        );
+    } else {
+        result.bits.resize(bitsetWords);
+        for (std::size_t word = 0; word < bitsetWords; ++word) {
+            result.bits[ word ] = a.bits[ word ] & b.bits[ word ];
+            result.cardinality += std::popcount(result.bits[ word ]);
+        }
+        if (result.cardinality <= arrayLimit)
+            result.toArray();
+        return result;
+    }
+
+    result.cardinality = static_cast<std::uint32_t>(result.array.size());
+    return result;
+}
+
+QLoguruBitmap::container_t
+QLoguruBitmap::unite(const container_t& a, const container_t& b)
+{
+    container_t result { a.key };
+    if (!a.isBitset() && !b.isBitset() &&
+        a.cardinality + b.cardinality <= arrayLimit) {
+        std::set_union(
+            a.array.begin(),
+            a.array.end(),
+            b.array.begin(),
+            b.array.end(),
+            std::back_inserter(result.array)
+        );
+        result.cardinality = static_cast<std::uint32_t>(result.array.size());
+        return result;
+    }
+
+    result.bits.resize(bitsetWords);
+    for (const container_t* source : { &a, &b }) {
+        if (source->isBitset()) {
+            for (std::size_t word = 0; word < bitsetWords; ++word)
+                result.bits[ word ] |= source->bits[ word ];
+        } else {
+            for (std::uint16_t low : source->array)
+                result.bits[ low / 64 ] |= std::uint64_t(1) << (low % 64);
+        }
+    }
+    for (std::uint64_t word : result.bits)
+        result.cardinality += std::popcount(word);
+    return result;
+}
+
+void QLoguruBitmap::push(container_t&& container)
+{
+    if (container.cardinality == 0)
+        return;
+
+    _cardinality += container.cardinality;
+    _containers.push_back(std::move(container));
+}
+
+bool QLoguruBitmap::container_t::contains(std::uint16_t low) const
+{
+    if (isBitset())
+        return (bits[ low / 64 ] >> (low % 64)) & 1;
+
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+void QLoguruBitmap::container_t::add(std::uint16_t low)
+{
+    ++cardinality;
+    if (isBitset()) {
+        bits[ low / 64 ] |= std::uint64_t(1) << (low % 64);
+        return;
+    }
+
+    array.push_back(low);
+    if (cardinality > arrayLimit)
+        toBitset();
+}
+
+void QLoguruBitmap::container_t::removeBefore(std::uint16_t low)
+{
+    if (!isBitset()) {
+        array.erase(
+            array.begin(), std::lower_bound(array.begin(), array.end(), low)
+        );
+        cardinality = static_cast<std::uint32_t>(array.size());
+        return;
+    }
+
+    std::size_t word = low / 64;
+    std::fill(bits.begin(), bits.begin() + word, 0);
+    bits[ word ] &= ~((std::uint64_t(1) << (low % 64)) - 1);
+
+    cardinality = 0;
+    for (std::uint64_t value : bits)
+        cardinality += std::popcount(value);
+    if (cardinality <= arrayLimit)
+        toArray();
+}
+
+void QLoguruBitmap::container_t::toBitset()
+{
+    bits.assign(bitsetWords, 0);
+    for (std::uint16_t value : array)
+        bits[ value / 64 ] |= std::uint64_t(1) << (value % 64);
+    array = {};
+}
+
+void QLoguruBitmap::container_t::toArray()
+{
+    array.clear();
+    array.reserve(cardinality);
+    for (std::size_t word = 0; word < bitsetWords; ++word) {
+        std::uint64_t value = bits[ word ];
+        while (value != 0) {
+            array.push_back(
+                static_cast<std::uint16_t>(word * 64 + std::countr_zero(value))
+            );
+            value &= value - 1;
+        }
+    }
+    bits = {};
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+/**
+ * Compressed bitmap of absolute row ids, in the spirit of Roaring bitmaps.
+ *
+ * Ids are split into chunks of 65536, every chunk present in the set is a
+ * container holding the low 16 bits of its ids: a sorted array while it's
+ * sparse, a plain bitset once it holds more than arrayLimit ids. Ids are only
+ * ever added in increasing order and removed from the front, like the rows
+ * of the storage.
+ */
+class QLoguruBitmap
+{
+public:
+    static constexpr std::uint32_t arrayLimit = 4096;
+
+public:
+    /**
+     * @brief Add an id, it must be greater than every id in the set.
+     */
+    void add(std::uint64_t id);
+
+    /**
+     * @brief Remove every id smaller than the given one.
+     */
+    void removeBefore(std::uint64_t id);
+    void clear();
+
+    std::size_t cardinality() const { return _cardinality; }
+    bool empty() const { return _cardinality == 0; }
+    bool contains(std::uint64_t id) const;
+
+    /**
+     * @brief Call the function with every id of the set, in order.
+     */
+    template<typename Function>
+    void forEach(Function&& function) const
+    {
+        forEachIn(0, std::numeric_limits<std::uint64_t>::max(), function);
+    }
+
+    /**
+     * @brief Call the function with every id of the set from begin up to
+     * end excluded, in order.
+     */
+    template<typename Function>
+    void forEachIn(
+        std::uint64_t begin, std::uint64_t end, Function&& function
+    ) const
+    {
+        // The containers before the range aren't looked at.
+        auto first = std::lower_bound(
+            _containers.begin(),
+            _containers.end(),
+            begin >> 16,
+            [](const container_t& container, std::uint64_t key) {
+            return container.key < key;
+            }
+        );
+        for (auto it = first; it != _containers.end(); ++it) {
+            const container_t& container = *it;
+            std::uint64_t base = container.key << 16;
+            if (base >= end)
+                break;
+
+            if (!container.isBitset()) {
+                for (std::uint16_t low : container.array) {
+                    std::uint64_t id = base | low;
+                    if (id >= end)
+                        break;
+                    if (id >= begin)
+                        function(id);
+                }
+                continue;
+            }
+
+            std::size_t firstWord =
+                begin > base ? static_cast<std::size_t>(begin - base) / 64 : 0;
+            for (std::size_t word = firstWord; word < bitsetWords; ++word) {
+                std::uint64_t bits = container.bits[ word ];
+                while (bits != 0) {
+                    std::uint64_t id =
+                        base | (word * 64 + std::countr_zero(bits));
+                    if (id >= end)
+                        return;
+                    if (id >= begin)
+                        function(id);
+                    bits &= bits - 1;
+                }
+            }
+        }
+    }
+
+    QLoguruBitmap operator&(const QLoguruBitmap& other) const;
+    QLoguruBitmap operator|(const QLoguruBitmap& other) const;
+
+    std::size_t memoryUsage() const;
+
+private:
+    static constexpr std::size_t bitsetWords = 65536 / 64;
+
+    struct container_t {
+        std::uint64_t key;
+        std::uint32_t cardinality = 0;
+        std::vector<std::uint16_t> array;
+        std::vector<std::uint64_t> bits;
+
+        bool isBitset() const { return !bits.empty(); }
+        bool contains(std::uint16_t low) const;
+        void add(std::uint16_t low);
+        void removeBefore(std::uint16_t low);
+        void toBitset();
+        void toArray();
+    };
+
+    static container_t intersect(const container_t& a, const container_t& b);
+    static container_t unite(const container_t& a, const container_t& b);
+    void push(container_t&& container);
+
+private:
+    std::deque<container_t> _containers;
+    std::size_t _cardinality = 0;
+};
@@ -0,0 +1,312 @@
+#include <QByteArray>
+#include <QSaveFile>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "qloguru_capture.hpp"
+#include "qloguru_levels.hpp"
+
+namespace
+{
+
+static constexpr char captureMagic[ 8 ] = {
+    'Q', 'L', 'O', 'G', 'U', 'R', 'U', 'C'
+};
+static constexpr std::uint32_t captureVersion = 1;
+static constexpr std::uint32_t byteOrderMark = 0x01020304;
+// zlib's fastest level, the columns compress well enough with it.
+static constexpr int captureCompression = 1;
+
+// Bytes of a block besides its messages, per row.
+static constexpr std::size_t fixedRowBytes =
+    sizeof(std::int64_t) * 2 + sizeof(std::uint64_t) +
+    sizeof(std::uint32_t) * 3 + sizeof(std::int8_t);
+
+struct header_t {
+    char magic[ 8 ];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+};
+
+// Last in the file, the index is only known once the blocks are written.
+struct footer_t {
+    std::uint64_t rows;
+    std::uint64_t blocks;
+    std::uint64_t indexOffset;
+    char magic[ 8 ];
+};
+
+template<typename T>
+bool writeValues(QSaveFile& file, const T* data, std::size_t count)
+{
+    auto bytes = static_cast<qint64>(count * sizeof(T));
+    return file.write(reinterpret_cast<const char*>(data), bytes) == bytes;
+}
+
+bool writeNames(QSaveFile& file, const QLoguruStringTable& names)
+{
+    auto count = static_cast<std::uint32_t>(names.size());
+    if (!writeValues(file, &count, 1))
+        return false;
+
+    for (std::uint32_t id = 0; id < count; ++id) {
+        std::string_view name = names[ id ];
+        auto length = static_cast<std::uint32_t>(name.size());
+        if (!writeValues(file, &length, 1) ||
+            !writeValues(file, name.data(), name.size()))
+            return false;
+    }
+
+    return true;
+}
+
+template<typename T>
+void appendValues(QByteArray& bytes, const std::vector<T>& values)
+{
+    bytes.append(
+        reinterpret_cast<const char*>(values.data()),
+        static_cast<int>(values.size() * sizeof(T))
+    );
+}
+
+// Columns in the order of a spilled segment.
+QByteArray serialize(const QLoguruStorage::columns_t& columns)
+{
+    QByteArray result;
+    result.reserve(static_cast<int>(
+        columns.time.size() * fixedRowBytes + columns.messages.size() +
+        sizeof(std::uint64_t)
+    ));
+    appendValues(result, columns.time);
+    appendValues(result, columns.elapsed);
+    appendValues(result, columns.messageOffset);
+    appendValues(result, columns.line);
+    appendValues(result, columns.logger);
+    appendValues(result, columns.file);
+    appendValues(result, columns.level);
+    result.append(
+        columns.messages.data(), static_cast<int>(columns.messages.size())
+    );
+    return result;
+}
+
+// Bounds checked reads, the values may not be aligned in the mapping.
+class cursor_t
+{
+public:
+    cursor_t(const uchar* begin, const uchar* end)
+        : _cursor(begin)
+        , _end(end)
+    {
+    }
+
+    template<typename T>
+    bool take(T* values, std::size_t count)
+    {
+        std::size_t bytes = count * sizeof(T);
+        if (!fits(bytes))
+            return false;
+
+        std::memcpy(values, _cursor, bytes);
+        _cursor += bytes;
+        return true;
+    }
+
+    template<typename T>
+    bool take(std::vector<T>& values, std::size_t count)
+    {
+        if (!fits(count * sizeof(T)))
+            return false;
+
+        values.resize(count);
+        return take(values.data(), count);
+    }
+
+    bool take(std::string& text, std::size_t count)
+    {
+        if (!fits(count))
+            return false;
+
+        text.resize(count);
+        return take(text.data(), count);
+    }
+
+    bool takeNames(std::vector<std::string>& names)
+    {
+        std::uint32_t count;
+        if (!take(&count, 1))
+            return false;
+
+        names.clear();
+        for (std::uint32_t id = 0; id < count; ++id) {
+            std::uint32_t length;
+            if (!take(&length, 1) || !take(names.emplace_back(), length))
+                return false;
+        }
+
+        return true;
+    }
+
+    bool atEnd() const { return _cursor == _end; }
+
+private:
+    bool fits(std::size_t bytes) const
+    {
+        return static_cast<std::size_t>(_end - _cursor) >= bytes;
+    }
+
+private:
+    const uchar* _cursor;
+    const uchar* _end;
+};
+
+} // namespace
+
+bool QLoguruCapture::save(const QString& path, const QLoguruStorage& storage)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    header_t header;
+    std::memcpy(header.magic, captureMagic, sizeof(header.magic));
+    header.version = captureVersion;
+    header.byteOrder = byteOrderMark;
+    bool isWritten = writeValues(file, &header, 1);
+
+    std::vector<block_t> blocks;
+    std::uint64_t offset = sizeof(header_t);
+    for (std::size_t first = 0; isWritten && first < storage.size();
+         first += blockRows) {
+        std::size_t rows = std::min(blockRows, storage.size() - first);
+        QLoguruStorage::columns_t columns = storage.columns(first, rows);
+
+        block_t block = { offset,
+                          0,
+                          static_cast<std::uint32_t>(rows),
+                          0,
+                          INT64_MAX,
+                          INT64_MIN };
+        for (std::size_t row = 0; row < rows; ++row) {
+            block.levels |= 1u << QLoguruLevels::index(columns.level[ row ]);
+            block.minTime = std::min(block.minTime, columns.time[ row ]);
+            block.maxTime = std::max(block.maxTime, columns.time[ row ]);
+        }
+
+        QByteArray payload = qCompress(serialize(columns), captureCompression);
+        isWritten = file.write(payload) == payload.size();
+        block.bytes = static_cast<std::uint64_t>(payload.size());
+        offset += block.bytes;
+        blocks.push_back(block);
+    }
+
+    footer_t footer;
+    footer.rows = storage.size();
+    footer.blocks = blocks.size();
+    footer.indexOffset = offset;
+    std::memcpy(footer.magic, captureMagic, sizeof(footer.magic));
+
+    isWritten = isWritten && writeValues(file, blocks.data(), blocks.size()) &&
+                writeNames(file, storage.loggerNames()) &&
+                writeNames(file, storage.fileNames()) &&
+                writeValues(file, &footer, 1);
+
+    // Not committing leaves the previous file in place.
+    return isWritten && file.commit();
+}
+
+bool QLoguruCapture::open(const QString& path)
+{
+    _file.close();
+    _data = nullptr;
+    _bytes = 0;
+    _rows = 0;
+    _blocks.clear();
+    _loggerNames.clear();
+    _fileNames.clear();
+
+    _file.setFileName(path);
+    if (!_file.open(QIODevice::ReadOnly) ||
+        _file.size() < qint64(sizeof(header_t) + sizeof(footer_t)))
+        return false;
+
+    _bytes = static_cast<std::size_t>(_file.size());
+    _data = _file.map(0, _file.size());
+    if (!_data)
+        return false;
+
+    header_t header;
+    footer_t footer;
+    const uchar* end = _data + _bytes;
+    cursor_t(_data, end).take(&header, 1);
+    cursor_t(end - sizeof(footer_t), end).take(&footer, 1);
+    if (std::memcmp(header.magic, captureMagic, sizeof(header.magic)) != 0 ||
+        std::memcmp(footer.magic, captureMagic, sizeof(footer.magic)) != 0 ||
+        header.version != captureVersion || header.byteOrder != byteOrderMark ||
+        footer.indexOffset < sizeof(header_t) ||
+        footer.indexOffset > _bytes - sizeof(footer_t))
+        return false;
+
+    cursor_t index(_data + footer.indexOffset, end - sizeof(footer_t));
+    if (footer.blocks > _bytes / sizeof(block_t) ||
+        !index.take(_blocks, footer.blocks) ||
+        !index.takeNames(_loggerNames) || !index.takeNames(_fileNames) ||
+        !index.atEnd())
+        return false;
+
+    for (const block_t& block : _blocks) {
+        if (block.offset < sizeof(header_t) ||
+            block.offset > footer.indexOffset || block.bytes > INT_MAX ||
+            block.bytes > footer.indexOffset - block.offset ||
+            block.rows > blockRows)
+            return false;
+
+        _rows += block.rows;
+    }
+
+    return _rows == footer.rows;
+}
+
+bool QLoguruCapture::read(
+    std::size_t block, QLoguruStorage::columns_t& columns
+) const
+{
+    const block_t& info = _blocks[ block ];
+    QByteArray payload =
+        qUncompress(_data + info.offset, static_cast<int>(info.bytes));
+
+    const std::size_t rows = info.rows;
+    if (static_cast<std::size_t>(payload.size()) <
+        rows * fixedRowBytes + sizeof(std::uint64_t))
+        return false;
+
+    auto begin = reinterpret_cast<const uchar*>(payload.constData());
+    cursor_t cursor(begin, begin + payload.size());
+    cursor.take(columns.time, rows);
+    cursor.take(columns.elapsed, rows);
+    cursor.take(columns.messageOffset, rows + 1);
+    cursor.take(columns.line, rows);
+    cursor.take(columns.logger, rows);
+    cursor.take(columns.file, rows);
+    cursor.take(columns.level, rows);
+
+    // Whatever is left are the messages, the offsets have to agree.
+    std::size_t messages =
+        payload.size() - rows * fixedRowBytes - sizeof(std::uint64_t);
+    if (!cursor.take(columns.messages, messages) ||
+        columns.messageOffset.front() != 0 ||
+        columns.messageOffset.back() != messages ||
+        !std::is_sorted(
+            columns.messageOffset.begin(), columns.messageOffset.end()
+        ))
+        return false;
+
+    auto isKnown = [](const std::vector<std::uint32_t>& ids, std::size_t size) {
+        return std::all_of(ids.begin(), ids.end(), [ size ](std::uint32_t id) {
+            return id < size;
+        });
+    };
+    return isKnown(columns.logger, _loggerNames.size()) &&
+           isKnown(columns.file, _fileNames.size());
+}
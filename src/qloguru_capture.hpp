@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "qloguru_storage.hpp"
+
+/**
+ * Binary capture of the rows of a QLoguruStorage.
+ *
+ * The rows are saved in blocks of blockRows rows, each block holding the
+ * columns in the layout of a spilled segment, compressed. An index at the end
+ * of the file gives the time span and the levels of every block, so blocks
+ * can be picked without being read. Reading a capture maps the file and
+ * appends whole blocks to the storage at once.
+ *
+ * The file is written in the byte order of the host and can't be read on a
+ * host of the other byte order.
+ */
+class QLoguruCapture
+{
+public:
+    static constexpr std::size_t blockRows = QLoguruSpillStore::defaultSegmentRows;
+
+    struct block_t {
+        std::uint64_t offset; // in the file
+        std::uint64_t bytes;  // compressed
+        std::uint32_t rows;
+        std::uint32_t levels; // bit QLoguruLevels::index(level) per level
+        std::int64_t minTime; // nanoseconds since epoch
+        std::int64_t maxTime;
+    };
+
+public:
+    /**
+     * @brief Save all the rows of the storage.
+     *
+     * The file is replaced only once the capture is complete.
+     */
+    static bool save(const QString& path, const QLoguruStorage& storage);
+
+    QLoguruCapture() = default;
+    QLoguruCapture(const QLoguruCapture&) = delete;
+    QLoguruCapture& operator=(const QLoguruCapture&) = delete;
+
+    /**
+     * @brief Map the file and read its index.
+     *
+     * @return false if the file can't be mapped or isn't a capture
+     */
+    bool open(const QString& path);
+
+    std::size_t size() const { return _rows; }
+    const std::vector<block_t>& blocks() const { return _blocks; }
+    const std::vector<std::string>& loggerNames() const { return _loggerNames; }
+    const std::vector<std::string>& fileNames() const { return _fileNames; }
+
+    /**
+     * @brief Decompress a block.
+     *
+     * The logger and file ids of the columns refer to loggerNames and
+     * fileNames.
+     *
+     * @return false if the block is corrupted
+     */
+    bool read(std::size_t block, QLoguruStorage::columns_t& columns) const;
+
+private:
+    QFile _file;
+    const uchar* _data = nullptr;
+    std::size_t _bytes = 0;
+    std::size_t _rows = 0;
+    std::vector<block_t> _blocks;
+    std::vector<std::string> _loggerNames;
+    std::vector<std::string> _fileNames;
+};
@@ -0,0 +1,137 @@
+#include <QHeaderView>
+#include <QTreeView>
+#include <algorithm>
+
+#include "qloguru_column_sizer.hpp"
+
+namespace
+{
+
+static constexpr int resizeInterval = 100; // milliseconds
+
+} // namespace
+
+QLoguruColumnSizer::QLoguruColumnSizer(
+    QTreeView* view, QAbstractItemModel* model, QObject* parent
+)
+    : QObject(parent)
+    , _view(view)
+    , _model(model)
+{
+    _timer.setSingleShot(true);
+    _timer.setInterval(resizeInterval);
+    connect(&_timer, &QTimer::timeout, this, &QLoguruColumnSizer::resizePending);
+
+    connect(
+        model,
+        &QAbstractItemModel::rowsInserted,
+        this,
+        [ this ](const QModelIndex&, int first, int last) {
+        rowsInserted(first, last);
+        }
+    );
+    connect(model, &QAbstractItemModel::modelReset, this, [ this ]() {
+        if (_isEnabled)
+            resizeColumns();
+    });
+}
+
+void QLoguruColumnSizer::setEnabled(bool enabled)
+{
+    _isEnabled = enabled;
+    _pendingFirst = -1;
+    _timer.stop();
+
+    if (enabled)
+        resizeColumns();
+}
+
+void QLoguruColumnSizer::resizeColumns()
+{
+    if (_view->model() != _model)
+        return;
+
+    std::vector<int> widths(_model->columnCount(), 0);
+    measure(0, _model->rowCount() - 1, sampleSize, widths);
+
+    QModelIndex top = _view->indexAt(QPoint(0, 0));
+    if (top.isValid()) {
+        int visibleRows = _view->viewport()->height() /
+                          std::max(1, _view->sizeHintForRow(top.row()));
+        measure(top.row(), top.row() + visibleRows, visibleRows + 1, widths);
+    }
+
+    widen(widths);
+}
+
+void QLoguruColumnSizer::rowsInserted(int first, int last)
+{
+    if (!_isEnabled)
+        return;
+
+    if (_pendingFirst < 0) {
+        _pendingFirst = first;
+        _pendingLast = last;
+    } else {
+        _pendingFirst = std::min(_pendingFirst, first);
+        _pendingLast = std::max(_pendingLast, last);
+    }
+
+    if (!_timer.isActive())
+        _timer.start();
+}
+
+void QLoguruColumnSizer::resizePending()
+{
+    int first = _pendingFirst;
+    int last = _pendingLast;
+    _pendingFirst = -1;
+
+    // Evicted rows may have shifted the range, it's only a sample anyway.
+    if (first < 0 || _view->model() != _model)
+        return;
+
+    std::vector<int> widths(_model->columnCount(), 0);
+    measure(first, last, sampleSize, widths);
+    widen(widths);
+}
+
+void QLoguruColumnSizer::measure(
+    int first, int last, int count, std::vector<int>& widths
+) const
+{
+    last = std::min(last, _model->rowCount() - 1);
+    first = std::max(0, std::min(first, last));
+    if (last < 0)
+        return;
+
+    // Evenly spread over the range, always including its last row.
+    int rows = last - first + 1;
+    int step = std::max(1, rows / std::max(1, count));
+    for (int row = last; row >= first; row -= step) {
+        for (int column = 0; column < static_cast<int>(widths.size());
+             ++column) {
+            if (_view->isColumnHidden(column))
+                continue;
+
+            QModelIndex index = _model->index(row, column);
+            widths[ column ] = std::max(
+                widths[ column ], _view->sizeHintForIndex(index).width()
+            );
+        }
+    }
+}
+
+void QLoguruColumnSizer::widen(const std::vector<int>& widths)
+{
+    QHeaderView* header = _view->header();
+    int stretched = header->logicalIndex(header->count() - 1);
+
+    for (int column = 0; column < static_cast<int>(widths.size()); ++column) {
+        if (header->stretchLastSection() && column == stretched)
+            continue;
+
+        if (widths[ column ] > header->sectionSize(column))
+            header->resizeSection(column, widths[ column ]);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <vector>
+
+class QAbstractItemModel;
+class QTreeView;
+
+/**
+ * Sizes the columns of a view to their contents as rows arrive.
+ *
+ * Resizing to the contents of every row gets slower as the log grows. The
+ * sizer instead measures a bounded sample of the rows inserted since its last
+ * pass, along with the visible ones, and only ever widens the columns. The
+ * passes are batched, a burst of insertions costs a single pass.
+ */
+class QLoguruColumnSizer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int sampleSize = 128; // rows per pass
+
+public:
+    QLoguruColumnSizer(
+        QTreeView* view, QAbstractItemModel* model, QObject* parent = nullptr
+    );
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _isEnabled; }
+
+    /**
+     * @brief Size the columns from the visible rows and a sample of all of
+     * them.
+     */
+    void resizeColumns();
+
+private:
+    void rowsInserted(int first, int last);
+    void resizePending();
+    void measure(int first, int last, int count, std::vector<int>& widths)
+        const;
+    void widen(const std::vector<int>& widths);
+
+private:
+    QTreeView* _view;
+    QAbstractItemModel* _model;
+    QTimer _timer;
+    bool _isEnabled = false;
+    // Rows inserted since the last pass, empty while _pendingFirst is -1.
+    int _pendingFirst = -1;
+    int _pendingLast = -1;
+};
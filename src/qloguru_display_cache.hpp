@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Bounded LRU cache of display strings.
+ *
+ * The views ask for the same cells over and over while painting and
+ * scrolling, the cache keeps the converted strings of the most recently used
+ * cells. QString is implicitly shared, so a hit costs a reference count
+ * increment.
+ */
+class QLoguruDisplayCache
+{
+public:
+    using key_t = std::uint64_t;
+
+public:
+    explicit QLoguruDisplayCache(std::size_t capacity)
+        : _capacity(capacity)
+    {
+    }
+
+    static key_t key(std::uint64_t rowId, int column)
+    {
+        return (rowId << 3) | static_cast<key_t>(column & 0x7);
+    }
+
+    const QString* find(key_t key)
+    {
+        auto it = _index.find(key);
+        if (it == _index.end())
+            return nullptr;
+
+        // move to the front, it's the most recently used one now
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return &it->second->second;
+    }
+
+    void insert(key_t key, const QString& value)
+    {
+        if (_capacity == 0)
+            return;
+
+        if (_entries.size() >= _capacity) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+
+        _entries.emplace_front(key, value);
+        _index[ key ] = _entries.begin();
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        _index.clear();
+    }
+
+    void setCapacity(std::size_t capacity)
+    {
+        _capacity = capacity;
+        while (_entries.size() > _capacity) {
+            _index.erase(_entries.back().first);
+            _entries.pop_back();
+        }
+    }
+
+    std::size_t capacity() const { return _capacity; }
+
+private:
+    using entry_t = std::pair<key_t, QString>;
+
+    std::size_t _capacity;
+    std::list<entry_t> _entries;
+    std::unordered_map<key_t, std::list<entry_t>::iterator> _index;
+};
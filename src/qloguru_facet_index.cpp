@@ -0,0 +1,59 @@
+#include <algorithm>
+
+#include "qloguru_facet_index.hpp"
+
+void QLoguruFacetIndex::append(
+    std::uint64_t id, int level, std::uint32_t loggerId
+)
+{
+    _levels[ QLoguruLevels::index(level) ].add(id);
+
+    if (loggerId >= _loggers.size())
+        _loggers.resize(loggerId + 1);
+    _loggers[ loggerId ].add(id);
+}
+
+void QLoguruFacetIndex::evict(std::uint64_t firstId)
+{
+    for (QLoguruBitmap& bitmap : _levels)
+        bitmap.removeBefore(firstId);
+    for (QLoguruBitmap& bitmap : _loggers)
+        bitmap.removeBefore(firstId);
+}
+
+QLoguruBitmap QLoguruFacetIndex::select(
+    const std::array<bool, QLoguruLevels::count>& visibleLevels,
+    const std::vector<bool>& visibleLoggers
+) const
+{
+    auto isLoggerVisible = [ & ](std::size_t id) {
+        return id >= visibleLoggers.size() || visibleLoggers[ id ];
+    };
+
+    bool allLevels = std::all_of(
+        visibleLevels.begin(), visibleLevels.end(), [](bool v) { return v; }
+    );
+    bool allLoggers = true;
+    for (std::size_t id = 0; id < _loggers.size(); ++id)
+        allLoggers = allLoggers && isLoggerVisible(id);
+
+    // Every row is in exactly one level and one logger, only the restricted
+    // side needs to be looked at.
+    QLoguruBitmap levels;
+    if (!allLevels || allLoggers) {
+        for (std::size_t i = 0; i < _levels.size(); ++i) {
+            if (visibleLevels[ i ])
+                levels = levels | _levels[ i ];
+        }
+        if (allLoggers)
+            return levels;
+    }
+
+    QLoguruBitmap loggers;
+    for (std::size_t id = 0; id < _loggers.size(); ++id) {
+        if (isLoggerVisible(id))
+            loggers = loggers | _loggers[ id ];
+    }
+
+    return allLevels ? loggers : levels & loggers;
+}
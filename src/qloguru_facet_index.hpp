@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "qloguru_bitmap.hpp"
+#include "qloguru_levels.hpp"
+
+/**
+ * Bitmaps of the rows of every level and every logger.
+ *
+ * The model keeps it up to date as rows are appended and evicted, so the
+ * number of rows of a level or logger is known at any time and the rows of
+ * any combination of them come down to a few bitmap operations.
+ */
+class QLoguruFacetIndex
+{
+public:
+    void append(std::uint64_t id, int level, std::uint32_t loggerId);
+    void evict(std::uint64_t firstId);
+
+    const QLoguruBitmap& level(int level) const
+    {
+        return _levels[ QLoguruLevels::index(level) ];
+    }
+
+    /**
+     * @brief Get the rows of the logger, nullptr if it has never had any.
+     */
+    const QLoguruBitmap* logger(std::uint32_t loggerId) const
+    {
+        return loggerId < _loggers.size() ? &_loggers[ loggerId ] : nullptr;
+    }
+
+    /**
+     * @brief Get the rows of the visible levels from the visible loggers.
+     *
+     * Loggers beyond the end of visibleLoggers are visible.
+     */
+    QLoguruBitmap select(
+        const std::array<bool, QLoguruLevels::count>& visibleLevels,
+        const std::vector<bool>& visibleLoggers
+    ) const;
+
+private:
+    std::array<QLoguruBitmap, QLoguruLevels::count> _levels;
+    // Indexed by the interned logger id.
+    std::deque<QLoguruBitmap> _loggers;
+};
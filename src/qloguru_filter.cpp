@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "qloguru_filter.hpp"
+
+#include "qloguru_model.hpp"
+
+namespace
+{
+
+static constexpr std::int64_t millisecondsPerSecond = 1000;
+static constexpr std::int64_t millisecondsPerMinute = 60000;
+static constexpr std::int64_t millisecondsPerHour = 3600000;
+static constexpr double nanosecondsPerSecond = 1e9;
+
+} // namespace
+
+QLoguruFilter::QLoguruFilter(
+    const QString& text, bool isRegularExpression, bool isCaseSensitive
+)
+    : _text(text)
+    , _freeText(text)
+    , _isRegularExpression(isRegularExpression)
+    , _caseSensitivity(isCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive)
+{
+    if (_isRegularExpression)
+        _regex = QLoguruRegex(text, isCaseSensitive);
+    else {
+        _query = QLoguruQuery(text, isCaseSensitive);
+        _freeText = _query.freeText();
+    }
+
+    _search = QLoguruSubstringSearch(_freeText.toStdString(), isCaseSensitive);
+
+    // Times, elapsed times and lines are made of digits, ':', '.' and 's'
+    // only, any other character required rules them out.
+    std::string literal = _isRegularExpression ? _regex.requiredLiteral()
+                                               : _freeText.toStdString();
+    _matchesNumbers =
+        !_freeText.isEmpty() &&
+        std::all_of(literal.begin(), literal.end(), [ & ](char c) {
+            return (c >= '0' && c <= '9') || c == ':' || c == '.' ||
+                   c == 's' || (c == 'S' && !isCaseSensitive);
+        });
+
+    _levelMatches.fill(unknown);
+}
+
+bool QLoguruFilter::isValid() const
+{
+    return _isRegularExpression ? _regex.isValid() : _query.isValid();
+}
+
+QString QLoguruFilter::errorString() const
+{
+    return _isRegularExpression ? _regex.errorString() : _query.errorString();
+}
+
+bool QLoguruFilter::accepts(const QLoguruModel& model, std::size_t row) const
+{
+    if (isEmpty())
+        return true;
+
+    // The predicates only look at a single typed column each, they're
+    // cheaper than any text search.
+    if (!_query.accepts(model, row))
+        return false;
+
+    if (_freeText.isEmpty())
+        return true;
+
+    const QLoguruStorage& storage = model.storage();
+
+    // The cheap, cached checks go first.
+    if (levelMatches(model.levels(), storage.level(row)))
+        return true;
+
+    if (nameMatches(
+            _loggerMatches, storage.loggerNames(), storage.loggerId(row)
+        ))
+        return true;
+
+    if (nameMatches(_fileMatches, storage.fileNames(), storage.fileId(row)))
+        return true;
+
+    if (_matchesNumbers && numberMatches(storage, row))
+        return true;
+
+    return matches(storage.message(row));
+}
+
+void QLoguruFilter::prepare(const QLoguruModel& model) const
+{
+    _query.prepare(model);
+    if (_freeText.isEmpty())
+        return;
+
+    const QLoguruStorage& storage = model.storage();
+    for (int level = QLoguruLevels::minLevel; level <= QLoguruLevels::maxLevel;
+         ++level)
+        levelMatches(model.levels(), level);
+
+    const QLoguruStringTable& loggers = storage.loggerNames();
+    for (std::uint32_t id = 0; id < loggers.size(); ++id)
+        nameMatches(_loggerMatches, loggers, id);
+
+    const QLoguruStringTable& files = storage.fileNames();
+    for (std::uint32_t id = 0; id < files.size(); ++id)
+        nameMatches(_fileMatches, files, id);
+}
+
+bool QLoguruFilter::matchesAnyName() const
+{
+    auto matched = [](const auto& cache) {
+        return std::find(cache.begin(), cache.end(), 1) != cache.end();
+    };
+    return _matchesNumbers || matched(_levelMatches) ||
+           matched(_loggerMatches) || matched(_fileMatches);
+}
+
+std::string QLoguruFilter::requiredLiteral() const
+{
+    if (_isRegularExpression)
+        return _regex.requiredLiteral();
+
+    if (_freeText.isEmpty())
+        return _query.requiredLiteral();
+
+    // Unicode case folding may match other bytes.
+    if (!_search.isCaseSensitive() && !_search.isAscii())
+        return {};
+
+    return _freeText.toStdString();
+}
+
+bool QLoguruFilter::isRefinementOf(const QLoguruFilter& other) const
+{
+    if (other.isEmpty())
+        return true;
+
+    // Nothing can be told about regular expressions or queries in general.
+    if (_isRegularExpression || other._isRegularExpression ||
+        !_query.isEmpty() || !other._query.isEmpty())
+        return false;
+
+    // Going from case sensitive to insensitive always widens the query.
+    if (other.isCaseSensitive() && !isCaseSensitive())
+        return false;
+
+    // Any field containing this text contains the other one as well.
+    return _text.contains(other._text, other._caseSensitivity);
+}
+
+bool QLoguruFilter::operator==(const QLoguruFilter& other) const
+{
+    return _text == other._text &&
+           _isRegularExpression == other._isRegularExpression &&
+           _caseSensitivity == other._caseSensitivity;
+}
+
+bool QLoguruFilter::levelMatches(const QLoguruLevels& levels, int level) const
+{
+    std::int8_t& result = _levelMatches[ QLoguruLevels::index(level) ];
+    if (result == unknown)
+        result = matches(levels.name(level));
+
+    return result;
+}
+
+bool QLoguruFilter::nameMatches(
+    std::vector<std::int8_t>& cache,
+    const QLoguruStringTable& names,
+    std::uint32_t id
+) const
+{
+    if (id >= cache.size())
+        cache.resize(names.size(), unknown);
+
+    if (cache[ id ] == unknown)
+        cache[ id ] = matches(names[ id ]);
+
+    return cache[ id ];
+}
+
+bool QLoguruFilter::numberMatches(
+    const QLoguruStorage& storage, std::size_t row
+) const
+{
+    // Formatted the way the model shows them.
+    char text[ 32 ];
+    std::int64_t time = _localTime.msecsOfDay(storage.time(row));
+    int length = std::snprintf(
+        text,
+        sizeof(text),
+        "%02d:%02d:%02d.%03d",
+        static_cast<int>(time / millisecondsPerHour),
+        static_cast<int>(time / millisecondsPerMinute % 60),
+        static_cast<int>(time / millisecondsPerSecond % 60),
+        static_cast<int>(time % millisecondsPerSecond)
+    );
+    if (matches(std::string_view(text, length)))
+        return true;
+
+    length = std::snprintf(
+        text, sizeof(text), "%.3fs", storage.elapsed(row) / nanosecondsPerSecond
+    );
+    if (matches(std::string_view(text, length)))
+        return true;
+
+    length = std::snprintf(text, sizeof(text), "%u", storage.line(row));
+    return matches(std::string_view(text, length));
+}
+
+bool QLoguruFilter::matches(std::string_view text) const
+{
+    if (_isRegularExpression)
+        return _regex.matches(text);
+
+    // A substring of valid UTF-8 can be searched byte-wise, ignoring the case
+    // only as long as folding ASCII letters is all it takes.
+    if (_search.isCaseSensitive() || _search.isAscii())
+        return _search.contains(text);
+
+    return matches(
+        QString::fromUtf8(text.data(), static_cast<int>(text.size()))
+    );
+}
+
+bool QLoguruFilter::matches(const QString& text) const
+{
+    if (_isRegularExpression)
+        return _regex.matches(text);
+
+    return text.contains(_freeText, _caseSensitivity);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "qloguru_levels.hpp"
+#include "qloguru_local_time.hpp"
+#include "qloguru_query.hpp"
+#include "qloguru_regex.hpp"
+#include "qloguru_substring_search.hpp"
+
+class QLoguruModel;
+class QLoguruStorage;
+class QLoguruStringTable;
+
+/**
+ * Text filter evaluated directly against the model's storage.
+ *
+ * A row matches if its level name, logger name, file name, message, or its
+ * time, elapsed time or line as shown contains the text (or matches the
+ * regular expression). Unless it's a regular expression the text may also
+ * contain the column predicates of QLoguruQuery, which must hold on top of
+ * that. Levels and names only have a few distinct values, their results are
+ * computed once and cached, so per row only the message is actually
+ * searched. The numbers are only formatted and searched when the text could
+ * be found in them at all. Because of the caches a filter must only be used
+ * with a single model.
+ */
+class QLoguruFilter
+{
+public:
+    QLoguruFilter() = default;
+    QLoguruFilter(
+        const QString& text, bool isRegularExpression, bool isCaseSensitive
+    );
+
+    bool isEmpty() const { return _text.isEmpty(); }
+    bool isValid() const;
+    QString errorString() const;
+
+    const QString& text() const { return _text; }
+    bool isRegularExpression() const { return _isRegularExpression; }
+    bool isCaseSensitive() const
+    {
+        return _caseSensitivity == Qt::CaseSensitive;
+    }
+
+    bool accepts(const QLoguruModel& model, std::size_t row) const;
+
+    /**
+     * @brief Evaluate the filter for every level and every name the model
+     * knows about.
+     *
+     * Afterwards accepting the rows present at this point only reads the
+     * caches, which is what makes a copy of the filter safe to use from
+     * another thread.
+     */
+    void prepare(const QLoguruModel& model) const;
+
+    /**
+     * @brief Check whether any level, logger or file name matches, or the
+     * text could be found in the times, elapsed times or lines.
+     *
+     * Only meaningful after prepare(). If not, only the rows whose message
+     * contains requiredLiteral() can be accepted.
+     */
+    bool matchesAnyName() const;
+
+    /**
+     * @brief The bytes every accepted message contains (ASCII letters in any
+     * case when ignoring the case), empty if there is no such literal.
+     */
+    std::string requiredLiteral() const;
+
+    /**
+     * @brief Check whether every row accepted by this filter is accepted by
+     * the other one as well, i.e. this one only narrows the other down.
+     */
+    bool isRefinementOf(const QLoguruFilter& other) const;
+
+    bool operator==(const QLoguruFilter& other) const;
+
+private:
+    bool levelMatches(const QLoguruLevels& levels, int level) const;
+    bool nameMatches(
+        std::vector<std::int8_t>& cache,
+        const QLoguruStringTable& names,
+        std::uint32_t id
+    ) const;
+    bool numberMatches(const QLoguruStorage& storage, std::size_t row) const;
+    bool matches(std::string_view text) const;
+    bool matches(const QString& text) const;
+
+private:
+    static constexpr std::int8_t unknown = -1;
+
+    QString _text;
+    // The text without the query predicates.
+    QString _freeText;
+    QLoguruQuery _query;
+    QLoguruSubstringSearch _search;
+    bool _isRegularExpression = false;
+    Qt::CaseSensitivity _caseSensitivity = Qt::CaseInsensitive;
+    QLoguruRegex _regex;
+    // Whether the text could be in a time, an elapsed time or a line at all.
+    bool _matchesNumbers = false;
+
+    mutable std::array<std::int8_t, QLoguruLevels::count> _levelMatches;
+    mutable std::vector<std::int8_t> _loggerMatches;
+    mutable std::vector<std::int8_t> _fileMatches;
+    mutable QLoguruLocalTime _localTime;
+};
@@ -0,0 +1,101 @@
+#include <algorithm>
+
+#include "qloguru_filter_scheduler.hpp"
+
+namespace
+{
+
+// Filters applied within a frame don't make typing lag, there is nothing to
+// win by delaying them.
+static constexpr qint64 immediateCost = 16000000; // nanoseconds
+static constexpr int minimumDelay = 50;            // milliseconds
+
+} // namespace
+
+QLoguruFilterScheduler::QLoguruFilterScheduler(apply_t apply, QObject* parent)
+    : QObject(parent)
+    , _apply(std::move(apply))
+{
+    _timer.setSingleShot(true);
+    connect(&_timer, &QTimer::timeout, this, &QLoguruFilterScheduler::apply);
+}
+
+void QLoguruFilterScheduler::schedule(settings_t settings)
+{
+    // Going back to what's applied already cancels the pending change.
+    if (settings == _applied) {
+        _pending.reset();
+        _timer.stop();
+        return;
+    }
+
+    _pending = std::move(settings);
+
+    int delay = currentDelay();
+    if (delay <= 0) {
+        _timer.stop();
+        apply();
+        return;
+    }
+
+    // Restarting the timer waits for the end of the burst.
+    _timer.start(delay);
+}
+
+void QLoguruFilterScheduler::flush()
+{
+    _timer.stop();
+    apply();
+}
+
+void QLoguruFilterScheduler::setMaximumDelay(int milliseconds)
+{
+    _maximumDelay = std::max(0, milliseconds);
+}
+
+void QLoguruFilterScheduler::finished()
+{
+    if (!_running.isValid())
+        return;
+
+    _lastCost = _running.nsecsElapsed();
+    _running.invalidate();
+}
+
+int QLoguruFilterScheduler::currentDelay() const
+{
+    // A filter still running costs at least as much as it took so far.
+    qint64 cost = _running.isValid()
+                      ? std::max(_lastCost, _running.nsecsElapsed())
+                      : _lastCost;
+    if (_maximumDelay == 0 || cost < immediateCost)
+        return 0;
+
+    // Twice the cost leaves the user time to type the next character.
+    // The maximum delay wins over the minimum one.
+    auto delay = static_cast<int>(cost * 2 / 1000000);
+    return std::clamp(
+        delay, std::min(minimumDelay, _maximumDelay), _maximumDelay
+    );
+}
+
+void QLoguruFilterScheduler::apply()
+{
+    if (!_pending)
+        return;
+
+    settings_t settings = std::move(_pending.value());
+    _pending.reset();
+
+    // Rejected settings leave the previous filter and its cost in place.
+    QElapsedTimer running;
+    running.start();
+    Result result = _apply(settings);
+    if (result == Result::Rejected)
+        return;
+
+    _applied = std::move(settings);
+    _running = running;
+    if (result == Result::Applied)
+        finished();
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <functional>
+#include <optional>
+
+#include "qloguru/qabstract_loguru_toolbar.hpp"
+
+/**
+ * Debounces the filter changes of a toolbar.
+ *
+ * Every change of the text, the regular expression or the case sensitivity
+ * replaces the pending one, so a burst of keystrokes is applied once, with
+ * the latest settings. How long the scheduler waits for the burst to end
+ * depends on how long applying the previous filter took: cheap filters are
+ * applied right away, expensive ones wait up to the maximum delay.
+ *
+ * Filters applied in the background take until finished() is called, the
+ * time they have been running so far counts while they are.
+ */
+class QLoguruFilterScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct settings_t {
+        QString text;
+        bool isRegularExpression;
+        bool isCaseSensitive;
+
+        bool operator==(const settings_t& other) const = default;
+    };
+
+    // What became of the settings given to apply_t.
+    enum class Result {
+        Rejected, // invalid, the previous filter stays
+        Applied,
+        Running // still being applied in the background
+    };
+    using apply_t = std::function<Result(const settings_t&)>;
+
+public:
+    explicit QLoguruFilterScheduler(apply_t apply, QObject* parent = nullptr);
+
+    void schedule(settings_t settings);
+
+    /**
+     * @brief Apply the pending settings now, if any.
+     */
+    void flush();
+
+    /**
+     * @brief Tell the scheduler the filter applied in the background is done.
+     */
+    void finished();
+
+    void setMaximumDelay(int milliseconds);
+    int maximumDelay() const { return _maximumDelay; }
+
+    /**
+     * @brief The delay the next change would be applied with.
+     */
+    int currentDelay() const;
+
+private:
+    void apply();
+
+private:
+    apply_t _apply;
+    QTimer _timer;
+    std::optional<settings_t> _pending;
+    std::optional<settings_t> _applied;
+    QElapsedTimer _running;
+    qint64 _lastCost = 0; // nanoseconds
+    int _maximumDelay = QAbstractLoguruToolBar::defaultMaximumFilterDelay;
+};
@@ -0,0 +1,362 @@
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+#include "qloguru_importer.hpp"
+#include "qloguru_levels.hpp"
+#include "qloguru_preamble_parser.hpp"
+
+namespace
+{
+
+static constexpr std::int64_t nanosecondsPerMillisecond = 1000000;
+static constexpr std::int64_t millisecondsPerMinute = 60000;
+
+// Chunks parsed ahead of the insertions, per thread of the pool.
+static constexpr int chunksAheadPerThread = 2;
+
+// Local time of the start of the hour last converted, times within the same
+// hour don't go through the time zone conversion again.
+struct hour_t {
+    QDate date;
+    int hour = -1;
+    std::int64_t start = 0; // milliseconds since epoch
+};
+
+int toNumber(std::string_view text)
+{
+    int result = 0;
+    for (char c : text)
+        result = result * 10 + (c - '0');
+    return result;
+}
+
+std::int64_t toTime(
+    const QLoguruPreambleParser::preamble_t& preamble,
+    const QDate& defaultDate,
+    hour_t& cache
+)
+{
+    // The parser checked the shapes, the parts are all digits.
+    if (preamble.time.empty())
+        return 0;
+
+    QDate date = preamble.date.empty()
+                     ? defaultDate
+                     : QDate(
+                           toNumber(preamble.date.substr(0, 4)),
+                           toNumber(preamble.date.substr(5, 2)),
+                           toNumber(preamble.date.substr(8, 2))
+                       );
+    int hour = toNumber(preamble.time.substr(0, 2));
+    if (!date.isValid() || hour > 23)
+        return 0;
+
+    if (date != cache.date || hour != cache.hour)
+        cache = { date,
+                  hour,
+                  QDateTime(date, QTime(hour, 0)).toMSecsSinceEpoch() };
+
+    std::int64_t milliseconds =
+        cache.start +
+        toNumber(preamble.time.substr(3, 2)) * millisecondsPerMinute +
+        toNumber(preamble.time.substr(6, 2)) * 1000 +
+        toNumber(preamble.time.substr(9, 3));
+    return milliseconds * nanosecondsPerMillisecond;
+}
+
+// Builtin names first, then the numbers loguru prints for the verbose
+// levels. Custom names can't be mapped back and count as info.
+int toLevel(std::string_view verbosity)
+{
+    for (std::size_t i = 0; i < QLoguruLevels::table.size(); ++i) {
+        const char* name = QLoguruLevels::table[ i ].builtinName;
+        if (name && verbosity == name)
+            return QLoguruLevels::minLevel + static_cast<int>(i);
+    }
+
+    bool isNegative = !verbosity.empty() && verbosity.front() == '-';
+    if (isNegative)
+        verbosity.remove_prefix(1);
+    if (verbosity.empty() || verbosity.size() > 3 ||
+        !std::all_of(verbosity.begin(), verbosity.end(), [](char c) {
+            return c >= '0' && c <= '9';
+        }))
+        return 0;
+
+    int level = toNumber(verbosity);
+    return isNegative ? -level : level;
+}
+
+// A message line starts with a preamble ending with the "|" before the
+// message. At least one part besides the verbosity is required, or any
+// continuation line with a "|" would do.
+bool parseMessageLine(
+    std::string_view line,
+    QLoguruPreambleParser::preamble_t& preamble,
+    std::size_t& pipe
+)
+{
+    pipe = line.find('|');
+    if (pipe == std::string_view::npos ||
+        !QLoguruPreambleParser::parse(line.substr(0, pipe + 1), preamble))
+        return false;
+
+    return !preamble.verbosity.empty() &&
+           (!preamble.time.empty() || !preamble.uptime.empty() ||
+            !preamble.thread.empty() || !preamble.file.empty());
+}
+
+std::string_view nextLine(std::string_view text, std::size_t& position)
+{
+    std::size_t end = text.find('\n', position);
+    if (end == std::string_view::npos)
+        end = text.size();
+
+    std::string_view line = text.substr(position, end - position);
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    position = end + 1;
+    return line;
+}
+
+} // namespace
+
+struct QLoguruImporter::import_t {
+    QFile file;
+    std::string_view text;
+    QDate defaultDate;
+    std::size_t chunkCount = 0;
+    std::atomic<bool> cancelled { false };
+    std::vector<std::vector<QLoguruModel::entry_t>> results;
+    std::unique_ptr<std::atomic<bool>[]> done;
+    // Only touched by the GUI thread.
+    std::size_t scheduled = 0;
+    std::size_t published = 0;
+};
+
+QLoguruImporter::QLoguruImporter(QLoguruModel* model, QObject* parent)
+    : QObject(parent)
+    , _model(model)
+{
+}
+
+QLoguruImporter::~QLoguruImporter()
+{
+    if (_import)
+        _import->cancelled.store(true, std::memory_order_relaxed);
+    waitForWorkers();
+}
+
+bool QLoguruImporter::start(const QString& path)
+{
+    cancel();
+
+    auto import = std::make_shared<import_t>();
+    import->file.setFileName(path);
+    if (!import->file.open(QIODevice::ReadOnly))
+        return false;
+
+    // loguru leaves the date out of the preamble on request, the file was
+    // most likely written the day it was last modified.
+    import->defaultDate = QFileInfo(import->file).lastModified().date();
+
+    qint64 size = import->file.size();
+    if (size > 0) {
+        uchar* data = import->file.map(0, size);
+        if (!data)
+            return false;
+
+        import->text = { reinterpret_cast<const char*>(data),
+                         static_cast<std::size_t>(size) };
+    }
+
+    import->chunkCount = (import->text.size() + chunkBytes - 1) / chunkBytes;
+    import->results.resize(import->chunkCount);
+    import->done = std::make_unique<std::atomic<bool>[]>(import->chunkCount);
+    _import = import;
+
+    emit importProgress(0, size);
+    schedule();
+
+    // Nothing to parse, there won't be any chunk to publish.
+    if (import->chunkCount == 0)
+        publish();
+
+    return true;
+}
+
+void QLoguruImporter::cancel()
+{
+    if (!_import)
+        return;
+
+    // The workers skip the chunks they haven't started yet, their results are
+    // ignored.
+    _import->cancelled.store(true, std::memory_order_relaxed);
+    _import.reset();
+    emit importFinished(false);
+}
+
+void QLoguruImporter::schedule()
+{
+    std::shared_ptr<import_t> import = _import;
+    std::size_t ahead = static_cast<std::size_t>(
+        chunksAheadPerThread * std::max(1, QThread::idealThreadCount())
+    );
+
+    while (import->scheduled < import->chunkCount &&
+           import->scheduled < import->published + ahead) {
+        std::size_t chunk = import->scheduled++;
+
+        auto work = [ this, import, chunk ]() {
+            if (!import->cancelled.load(std::memory_order_relaxed)) {
+                // Both ends are found the same way by the neighbouring
+                // chunks, so every message is parsed exactly once.
+                std::string_view text = import->text;
+                std::size_t begin =
+                    chunk == 0 ? 0 : nextMessage(text, chunk * chunkBytes);
+                std::size_t end = nextMessage(text, (chunk + 1) * chunkBytes);
+                parse(
+                    text.substr(begin, std::max(begin, end) - begin),
+                    import->defaultDate,
+                    import->results[ chunk ]
+                );
+            }
+
+            import->done[ chunk ].store(true, std::memory_order_release);
+            QMetaObject::invokeMethod(
+                this, [ this ]() { publish(); }, Qt::QueuedConnection
+            );
+
+            std::lock_guard lock(_workersMutex);
+            if (--_workers == 0)
+                _workersFinished.notify_all();
+        };
+
+        {
+            std::lock_guard lock(_workersMutex);
+            ++_workers;
+        }
+        QThreadPool::globalInstance()->start(work);
+    }
+}
+
+void QLoguruImporter::publish()
+{
+    if (!_import)
+        return;
+
+    // Insert the parsed chunks in order, a slow chunk holds back the ones
+    // after it.
+    std::shared_ptr<import_t> import = _import;
+    std::vector<QLoguruModel::entry_t> entries;
+    while (import->published < import->chunkCount &&
+           import->done[ import->published ].load(std::memory_order_acquire)) {
+        auto& result = import->results[ import->published ];
+        if (entries.empty())
+            entries = std::move(result);
+        else
+            std::move(
+                result.begin(), result.end(), std::back_inserter(entries)
+            );
+        result = {};
+        ++import->published;
+    }
+
+    if (!entries.empty())
+        _model->addEntries(entries);
+
+    // The insertion may have led to the import being cancelled.
+    if (_import != import)
+        return;
+
+    qint64 total = static_cast<qint64>(import->text.size());
+    qint64 read = std::min<qint64>(import->published * chunkBytes, total);
+    bool finished = import->published == import->chunkCount;
+    if (finished)
+        _import.reset();
+    else
+        schedule();
+
+    emit importProgress(read, total);
+    if (finished)
+        emit importFinished(true);
+}
+
+void QLoguruImporter::waitForWorkers()
+{
+    std::unique_lock lock(_workersMutex);
+    _workersFinished.wait(lock, [ this ]() { return _workers == 0; });
+}
+
+void QLoguruImporter::parse(
+    std::string_view text,
+    const QDate& defaultDate,
+    std::vector<QLoguruModel::entry_t>& entries
+)
+{
+    QLoguruPreambleParser::preamble_t preamble;
+    hour_t hour;
+    std::size_t position = 0;
+    while (position < text.size()) {
+        std::string_view line = nextLine(text, position);
+
+        std::size_t pipe;
+        if (!parseMessageLine(line, preamble, pipe)) {
+            if (!entries.empty()) {
+                entries.back().message += '\n';
+                entries.back().message += line;
+            }
+            continue;
+        }
+
+        QLoguruModel::entry_t& entry = entries.emplace_back();
+        entry.time = toTime(preamble, defaultDate, hour);
+        entry.elapsed = QLoguruPreambleParser::toNanoseconds(preamble.uptime);
+        entry.level = toLevel(preamble.verbosity);
+        entry.loggerName = preamble.thread;
+        entry.file = preamble.file;
+        entry.line = preamble.line;
+
+        // loguru separates the message from the preamble with a space.
+        std::string_view message = line.substr(pipe + 1);
+        if (!message.empty() && message.front() == ' ')
+            message.remove_prefix(1);
+        entry.message = message;
+    }
+}
+
+std::size_t QLoguruImporter::nextMessage(
+    std::string_view text, std::size_t from
+)
+{
+    if (from >= text.size())
+        return text.size();
+
+    // Move to the start of the line after the one the offset falls in,
+    // unless it starts a line itself.
+    std::size_t position = from;
+    if (position > 0 && text[ position - 1 ] != '\n') {
+        position = text.find('\n', position);
+        if (position == std::string_view::npos)
+            return text.size();
+        ++position;
+    }
+
+    QLoguruPreambleParser::preamble_t preamble;
+    while (position < text.size()) {
+        std::size_t start = position;
+        std::size_t pipe;
+        if (parseMessageLine(nextLine(text, position), preamble, pipe))
+            return start;
+    }
+
+    return text.size();
+}
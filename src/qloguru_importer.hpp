@@ -0,0 +1,84 @@
+#pragma once
+
+#include <QDate>
+#include <QObject>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "qloguru_model.hpp"
+
+/**
+ * Streams a log file written by loguru::add_file into the model.
+ *
+ * The file is mapped and cut into chunks of about chunkBytes, each starting
+ * with a message line. The chunks are parsed in parallel on the global thread
+ * pool and inserted into the model in order, one batch per chunk, from the
+ * event loop. Only a few chunks are parsed ahead of the insertions, so the
+ * first rows show up right away and the memory use doesn't depend on the size
+ * of the file.
+ */
+class QLoguruImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t chunkBytes = 4 << 20;
+
+public:
+    explicit QLoguruImporter(QLoguruModel* model, QObject* parent = nullptr);
+    ~QLoguruImporter() override;
+
+    /**
+     * @brief Start importing the file, cancelling the import in progress.
+     *
+     * @return false if the file can't be opened
+     */
+    bool start(const QString& path);
+
+    /**
+     * @brief Stop importing, the rows already inserted stay.
+     */
+    void cancel();
+
+    bool isImporting() const { return _import != nullptr; }
+
+    /**
+     * @brief Parse the lines of a log file.
+     *
+     * Lines without a preamble continue the message before them, those
+     * before the first message are skipped. Times without a date are taken
+     * on defaultDate.
+     */
+    static void parse(
+        std::string_view text,
+        const QDate& defaultDate,
+        std::vector<QLoguruModel::entry_t>& entries
+    );
+
+    /**
+     * @brief Get the offset of the first message line starting at or after
+     * the given offset, the size of the text if there's none.
+     */
+    static std::size_t nextMessage(std::string_view text, std::size_t from);
+
+signals:
+    void importProgress(qint64 read, qint64 total);
+    void importFinished(bool isComplete);
+
+private:
+    struct import_t;
+
+    void schedule();
+    void publish();
+    void waitForWorkers();
+
+private:
+    QLoguruModel* _model;
+    std::shared_ptr<import_t> _import;
+    std::mutex _workersMutex;
+    std::condition_variable _workersFinished;
+    int _workers = 0;
+};
@@ -0,0 +1,37 @@
+#include <cstring>
+#include <loguru.hpp>
+
+#include "qloguru_levels.hpp"
+
+const QString& QLoguruLevels::name(int level) const
+{
+    std::size_t i = index(level);
+    if (!_names[ i ]) {
+        int verbosity = static_cast<int>(i) + minLevel;
+        const char* name = loguru::get_verbosity_name(
+            static_cast<loguru::Verbosity>(verbosity)
+        );
+
+        // loguru falls back to its own abbreviations when no callback is set
+        // or the callback doesn't know the level, prefer the readable names
+        // in that case.
+        const char* builtinName = table[ i ].builtinName;
+        bool isBuiltin =
+            !name || (builtinName && std::strcmp(name, builtinName) == 0);
+        _names[ i ] = QString(isBuiltin ? table[ i ].name : name);
+    }
+
+    return _names[ i ].value();
+}
+
+const QIcon& QLoguruLevels::icon(int level) const
+{
+    // Loaded on first use, the resources may not be initialized before.
+    std::size_t i = index(level);
+    if (!_icons[ i ])
+        _icons[ i ] = QIcon(QString(table[ i ].icon));
+
+    return _icons[ i ].value();
+}
+
+void QLoguruLevels::refreshNames() { _names.fill(std::nullopt); }
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QIcon>
+#include <QString>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string_view>
+
+/**
+ * Display metadata of loguru's verbosity levels.
+ *
+ * The static table covers loguru's whole range, from FATAL (-3) to the most
+ * verbose level (9), and is indexed directly by the level. Names and icons
+ * are resolved once per level and then shared by every row, so painting a
+ * cell never allocates or loads a resource.
+ */
+class QLoguruLevels
+{
+public:
+    static constexpr int minLevel = -3; // loguru::Verbosity_FATAL
+    static constexpr int maxLevel = 9;  // loguru::Verbosity_MAX
+    static constexpr std::size_t count = maxLevel - minLevel + 1;
+
+    struct level_t {
+        const char* name;        // name displayed by default
+        const char* builtinName; // name loguru uses when not customized
+        const char* icon;        // resource path of the icon
+    };
+
+    static constexpr std::array<level_t, count> table = { {
+        { "Critical", "FATL", ":/res/critical.png" },
+        { "Error", "ERR", ":/res/error.png" },
+        { "Warning", "WARN", ":/res/warn.png" },
+        { "Info", "INFO", ":/res/info.png" },
+        { "Verbose 1", nullptr, ":/res/debug.png" },
+        { "Verbose 2", nullptr, ":/res/trace.png" },
+        { "Verbose 3", nullptr, ":/res/trace.png" },
+        { "Verbose 4", nullptr, ":/res/trace.png" },
+        { "Verbose 5", nullptr, ":/res/trace.png" },
+        { "Verbose 6", nullptr, ":/res/trace.png" },
+        { "Verbose 7", nullptr, ":/res/trace.png" },
+        { "Verbose 8", nullptr, ":/res/trace.png" },
+        { "Verbose 9", nullptr, ":/res/trace.png" },
+    } };
+
+    static constexpr std::size_t index(int level)
+    {
+        // Everything below FATAL is fatal as far as loguru is concerned.
+        return static_cast<std::size_t>(
+            std::clamp(level, minLevel, maxLevel) - minLevel
+        );
+    }
+
+public:
+    /**
+     * @brief Get the display name of the level.
+     *
+     * Names registered with loguru::set_verbosity_to_name_callback take
+     * precedence over the default ones.
+     */
+    const QString& name(int level) const;
+
+    /**
+     * @brief Get the icon of the level.
+     */
+    const QIcon& icon(int level) const;
+
+    /**
+     * @brief Resolve the names again, e.g. after the verbosity to name
+     * callback changed.
+     */
+    void refreshNames();
+
+private:
+    mutable std::array<std::optional<QString>, count> _names;
+    mutable std::array<std::optional<QIcon>, count> _icons;
+};
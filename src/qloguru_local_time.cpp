@@ -0,0 +1,34 @@
+#include <QDateTime>
+
+#include "qloguru_local_time.hpp"
+
+namespace
+{
+
+static constexpr std::int64_t nanosecondsPerMillisecond = 1000000;
+static constexpr std::int64_t millisecondsPerQuarter = 15 * 60 * 1000;
+static constexpr std::int64_t millisecondsPerDay = 24 * 60 * 60 * 1000;
+
+// Rounded towards negative infinity, times before the epoch included.
+std::int64_t floorDivide(std::int64_t value, std::int64_t divisor)
+{
+    std::int64_t result = value / divisor;
+    return value % divisor < 0 ? result - 1 : result;
+}
+
+} // namespace
+
+std::int64_t QLoguruLocalTime::msecsOfDay(std::int64_t time)
+{
+    std::int64_t milliseconds = floorDivide(time, nanosecondsPerMillisecond);
+    std::int64_t quarter = floorDivide(milliseconds, millisecondsPerQuarter);
+    if (quarter != _quarter) {
+        QDateTime start =
+            QDateTime::fromMSecsSinceEpoch(quarter * millisecondsPerQuarter);
+        _quarter = quarter;
+        _offset = start.offsetFromUtc() * 1000LL;
+    }
+
+    std::int64_t local = milliseconds + _offset;
+    return local - floorDivide(local, millisecondsPerDay) * millisecondsPerDay;
+}
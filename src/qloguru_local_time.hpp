@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Converts timestamps to the local time of day, the way the Time column
+ * shows them.
+ *
+ * Time zones only ever change their offset on a quarter of an hour, the
+ * offset of the quarter last converted is kept and reused for the times
+ * within it. Rows on both sides of a daylight saving change each get their
+ * own offset, for one time zone lookup per quarter of an hour of log.
+ */
+class QLoguruLocalTime
+{
+public:
+    /**
+     * @brief Milliseconds since the local midnight of a time in nanoseconds
+     * since epoch.
+     */
+    std::int64_t msecsOfDay(std::int64_t time);
+
+private:
+    // Quarter of an hour since epoch the offset is for.
+    std::int64_t _quarter = std::numeric_limits<std::int64_t>::min();
+    std::int64_t _offset = 0; // milliseconds
+};
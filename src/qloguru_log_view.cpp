@@ -0,0 +1,397 @@
+#include <QHeaderView>
+#include <QItemSelectionModel>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QStyle>
+#include <algorithm>
+
+#include "qloguru_log_view.hpp"
+#include "qloguru_model.hpp"
+#include "qloguru_proxy_model.hpp"
+
+namespace
+{
+
+static constexpr int cellMargin = 3;             // pixels, left and right
+static constexpr int rowMargin = 1;              // pixels, top and bottom
+static constexpr int layoutCacheCapacity = 4096; // rows
+
+} // namespace
+
+QLoguruLogView::QLoguruLogView(QWidget* parent)
+    : QAbstractScrollArea(parent)
+    , _header(new QHeaderView(Qt::Horizontal, this))
+    , _layouts(layoutCacheCapacity)
+{
+    // Same header as the one of QTreeView.
+    _header->setSectionsMovable(true);
+    _header->setStretchLastSection(true);
+    _header->setDefaultAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+
+    connect(_header, &QHeaderView::sectionResized, this, [ this ]() {
+        updateScrollBars();
+        viewport()->update();
+    });
+    connect(_header, &QHeaderView::sectionMoved, this, [ this ]() {
+        viewport()->update();
+    });
+    connect(_header, &QHeaderView::geometriesChanged, this, [ this ]() {
+        updateGeometries();
+    });
+
+    setFocusPolicy(Qt::StrongFocus);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
+    verticalScrollBar()->setSingleStep(1);
+    horizontalScrollBar()->setSingleStep(20);
+
+    updateRowHeight();
+    updateGeometries();
+}
+
+QLoguruLogView::~QLoguruLogView() { }
+
+void QLoguruLogView::setModel(QLoguruProxyModel* model)
+{
+    for (const QMetaObject::Connection& connection : _connections)
+        disconnect(connection);
+    _connections.clear();
+
+    delete _selection;
+    _selection = nullptr;
+
+    _model = model;
+    _source = model ? qobject_cast<QLoguruModel*>(model->sourceModel())
+                    : nullptr;
+    _header->setModel(model);
+
+    if (model) {
+        _selection = new QItemSelectionModel(model, this);
+
+        auto rowsChanged = [ this ]() {
+            updateScrollBars();
+            viewport()->update();
+        };
+        auto layoutsChanged = [ this ]() {
+            invalidateLayouts();
+            updateScrollBars();
+            viewport()->update();
+        };
+
+        _connections = {
+            connect(model, &QAbstractItemModel::rowsInserted, this, rowsChanged),
+            connect(model, &QAbstractItemModel::rowsRemoved, this, rowsChanged),
+            // A reset may come with new texts or names for the same ids,
+            // only the visible rows are laid out again anyway.
+            connect(
+                model, &QAbstractItemModel::modelReset, this, layoutsChanged
+            ),
+            connect(
+                model, &QAbstractItemModel::layoutChanged, this, layoutsChanged
+            ),
+            connect(
+                model, &QAbstractItemModel::dataChanged, this, layoutsChanged
+            ),
+            connect(
+                _selection,
+                &QItemSelectionModel::selectionChanged,
+                viewport(),
+                QOverload<>::of(&QWidget::update)
+            ),
+        };
+    }
+
+    invalidateLayouts();
+    updateScrollBars();
+    viewport()->update();
+}
+
+int QLoguruLogView::rowAt(int y) const
+{
+    if (!_model || y < 0)
+        return -1;
+
+    int row = verticalScrollBar()->value() + y / _rowHeight;
+    return row < _model->rowCount() ? row : -1;
+}
+
+void QLoguruLogView::scrollTo(int row)
+{
+    QScrollBar* bar = verticalScrollBar();
+    int visibleRows = std::max(1, viewport()->height() / _rowHeight);
+
+    if (row < bar->value())
+        bar->setValue(row);
+    else if (row >= bar->value() + visibleRows)
+        bar->setValue(row - visibleRows + 1);
+}
+
+void QLoguruLogView::scrollToBottom()
+{
+    // The range may lag behind rows inserted in the same event.
+    updateScrollBars();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+void QLoguruLogView::setLayoutCacheCapacity(int capacity)
+{
+    // The row being painted has to fit in.
+    _layouts.setMaxCost(std::max(1, capacity));
+}
+
+int QLoguruLogView::getLayoutCacheCapacity() const
+{
+    return static_cast<int>(_layouts.maxCost());
+}
+
+void QLoguruLogView::paintEvent(QPaintEvent* event)
+{
+    if (!_model)
+        return;
+
+    QPainter painter(viewport());
+    const QPalette& colors = palette();
+
+    int first = verticalScrollBar()->value();
+    int last = std::min(
+        _model->rowCount() - 1, first + viewport()->height() / _rowHeight
+    );
+
+    for (int row = first; row <= last; ++row) {
+        const row_t& layout = rowLayout(row);
+        QRect rowRect(
+            0, (row - first) * _rowHeight, viewport()->width(), _rowHeight
+        );
+
+        bool isSelected = _selection && _selection->isRowSelected(row);
+        if (isSelected)
+            painter.fillRect(rowRect, colors.highlight());
+        else if (layout.background)
+            painter.fillRect(rowRect, layout.background.value());
+
+        painter.setFont(layout.font);
+        painter.setPen(
+            isSelected ? colors.color(QPalette::HighlightedText)
+                       : layout.foreground.value_or(colors.color(QPalette::Text))
+        );
+
+        for (int visual = 0; visual < _header->count(); ++visual) {
+            int column = _header->logicalIndex(visual);
+            if (_header->isSectionHidden(column))
+                continue;
+
+            int x = _header->sectionViewportPosition(column) + cellMargin;
+            if (column == 0 && !layout.icon.isNull()) {
+                layout.icon.paint(
+                    &painter,
+                    x,
+                    rowRect.top() + (_rowHeight - _iconSize) / 2,
+                    _iconSize,
+                    _iconSize
+                );
+                x += _iconSize + cellMargin;
+            }
+
+            const QStaticText& text = layout.cells[ column ].text;
+            painter.drawStaticText(
+                x,
+                rowRect.top() +
+                    (_rowHeight - static_cast<int>(text.size().height())) / 2,
+                text
+            );
+        }
+    }
+}
+
+void QLoguruLogView::resizeEvent(QResizeEvent* event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateGeometries();
+}
+
+void QLoguruLogView::scrollContentsBy(int dx, int dy)
+{
+    if (dx != 0)
+        _header->setOffset(horizontalScrollBar()->value());
+
+    viewport()->update();
+}
+
+void QLoguruLogView::mousePressEvent(QMouseEvent* event)
+{
+    int row = rowAt(event->pos().y());
+    if (row >= 0 && event->button() == Qt::LeftButton)
+        setCurrentRow(row);
+
+    QAbstractScrollArea::mousePressEvent(event);
+}
+
+void QLoguruLogView::keyPressEvent(QKeyEvent* event)
+{
+    if (!_model || !_selection) {
+        QAbstractScrollArea::keyPressEvent(event);
+        return;
+    }
+
+    int current = _selection->currentIndex().isValid()
+                      ? _selection->currentIndex().row()
+                      : verticalScrollBar()->value();
+    int pageRows = std::max(1, viewport()->height() / _rowHeight);
+
+    switch (event->key()) {
+        case Qt::Key_Up: {
+            setCurrentRow(current - 1);
+            break;
+        }
+
+        case Qt::Key_Down: {
+            setCurrentRow(current + 1);
+            break;
+        }
+
+        case Qt::Key_PageUp: {
+            setCurrentRow(current - pageRows);
+            break;
+        }
+
+        case Qt::Key_PageDown: {
+            setCurrentRow(current + pageRows);
+            break;
+        }
+
+        case Qt::Key_Home: {
+            setCurrentRow(0);
+            break;
+        }
+
+        case Qt::Key_End: {
+            setCurrentRow(_model->rowCount() - 1);
+            break;
+        }
+
+        default: {
+            QAbstractScrollArea::keyPressEvent(event);
+            break;
+        }
+    }
+}
+
+void QLoguruLogView::changeEvent(QEvent* event)
+{
+    QAbstractScrollArea::changeEvent(event);
+
+    if (event->type() == QEvent::FontChange ||
+        event->type() == QEvent::StyleChange) {
+        updateRowHeight();
+        invalidateLayouts();
+        updateGeometries();
+    }
+}
+
+void QLoguruLogView::updateGeometries()
+{
+    int height = _header->isHidden() ? 0 : _header->sizeHint().height();
+    setViewportMargins(0, height, 0, 0);
+
+    QRect geometry = viewport()->geometry();
+    _header->setGeometry(
+        geometry.left(), geometry.top() - height, geometry.width(), height
+    );
+
+    updateScrollBars();
+}
+
+void QLoguruLogView::updateScrollBars()
+{
+    // The vertical scrollbar counts rows rather than pixels, it stays exact
+    // however many rows there are.
+    int rows = _model ? _model->rowCount() : 0;
+    int visibleRows = std::max(1, viewport()->height() / _rowHeight);
+    verticalScrollBar()->setRange(0, std::max(0, rows - visibleRows));
+    verticalScrollBar()->setPageStep(visibleRows);
+
+    int width = viewport()->width();
+    horizontalScrollBar()->setRange(0, std::max(0, _header->length() - width));
+    horizontalScrollBar()->setPageStep(width);
+}
+
+void QLoguruLogView::updateRowHeight()
+{
+    _iconSize = style()->pixelMetric(QStyle::PM_SmallIconSize, nullptr, this);
+    _rowHeight =
+        std::max(fontMetrics().height(), _iconSize) + 2 * rowMargin;
+}
+
+void QLoguruLogView::invalidateLayouts() { _layouts.clear(); }
+
+void QLoguruLogView::setCurrentRow(int row)
+{
+    if (!_model || !_selection || _model->rowCount() == 0)
+        return;
+
+    row = std::clamp(row, 0, _model->rowCount() - 1);
+    _selection->setCurrentIndex(
+        _model->index(row, 0),
+        QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows
+    );
+    scrollTo(row);
+}
+
+std::uint64_t QLoguruLogView::rowId(int row) const
+{
+    if (!_source)
+        return static_cast<std::uint64_t>(row);
+
+    QModelIndex source = _model->mapToSource(_model->index(row, 0));
+    return _source->storage().firstId() + source.row();
+}
+
+QLoguruLogView::row_t& QLoguruLogView::rowLayout(int row)
+{
+    std::uint64_t id = rowId(row);
+    row_t* layout = _layouts.object(id);
+    if (!layout) {
+        QModelIndex index = _model->index(row, 0);
+
+        layout = new row_t;
+        QVariant font = index.data(Qt::FontRole);
+        layout->font = font.isValid() ? font.value<QFont>() : this->font();
+        QVariant background = index.data(Qt::BackgroundRole);
+        if (background.isValid())
+            layout->background = background.value<QBrush>();
+        QVariant foreground = index.data(Qt::ForegroundRole);
+        if (foreground.isValid())
+            layout->foreground = foreground.value<QColor>();
+        layout->icon = index.data(Qt::DecorationRole).value<QIcon>();
+        layout->cells.resize(_model->columnCount());
+
+        _layouts.insert(id, layout);
+    }
+
+    // Cells are laid out again only once their width changes.
+    QFontMetrics metrics(layout->font);
+    for (int column = 0; column < static_cast<int>(layout->cells.size());
+         ++column) {
+        if (_header->isSectionHidden(column))
+            continue;
+
+        int width = _header->sectionSize(column) - 2 * cellMargin;
+        if (column == 0 && !layout->icon.isNull())
+            width -= _iconSize + cellMargin;
+
+        cell_t& cell = layout->cells[ column ];
+        if (cell.width == width)
+            continue;
+
+        QString text = _model->index(row, column).data().toString();
+        cell.text.setTextFormat(Qt::PlainText);
+        cell.text.setText(
+            metrics.elidedText(text, Qt::ElideRight, std::max(0, width))
+        );
+        cell.text.prepare(QTransform(), layout->font);
+        cell.width = width;
+    }
+
+    return *layout;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QFont>
+#include <QIcon>
+#include <QStaticText>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class QHeaderView;
+class QItemSelectionModel;
+class QLoguruModel;
+class QLoguruProxyModel;
+
+/**
+ * Flat view of the messages.
+ *
+ * Unlike QTreeView, the view knows every row has the same height: the first
+ * visible row is the value of the vertical scrollbar and only the visible
+ * rows are looked at, whatever the number of rows. The text of the cells is
+ * laid out once per row and width and kept in a cache keyed by the id of the
+ * message, which doesn't change as rows are appended, evicted or filtered.
+ *
+ * Columns are shown, hidden, resized and moved through the header, rows are
+ * selected one at a time like in the tree view.
+ */
+class QLoguruLogView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit QLoguruLogView(QWidget* parent = nullptr);
+    ~QLoguruLogView() override;
+
+    void setModel(QLoguruProxyModel* model);
+    QLoguruProxyModel* model() const { return _model; }
+
+    QHeaderView* header() const { return _header; }
+    QItemSelectionModel* selectionModel() const { return _selection; }
+
+    int rowHeight() const { return _rowHeight; }
+
+    /**
+     * @brief Get the row at the position of the viewport, -1 if none.
+     */
+    int rowAt(int y) const;
+
+    void scrollTo(int row);
+    void scrollToBottom();
+
+    /**
+     * @brief Set the number of rows whose layout is kept.
+     */
+    void setLayoutCacheCapacity(int capacity);
+    int getLayoutCacheCapacity() const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void changeEvent(QEvent* event) override;
+
+private:
+    struct cell_t {
+        int width = -1;
+        QStaticText text;
+    };
+
+    // Everything the painting of a row needs, resolved once.
+    struct row_t {
+        QFont font;
+        std::optional<QBrush> background;
+        std::optional<QColor> foreground;
+        QIcon icon;
+        std::vector<cell_t> cells;
+    };
+
+    void updateGeometries();
+    void updateScrollBars();
+    void updateRowHeight();
+    void invalidateLayouts();
+    void setCurrentRow(int row);
+    std::uint64_t rowId(int row) const;
+    row_t& rowLayout(int row);
+
+private:
+    QLoguruProxyModel* _model = nullptr;
+    QLoguruModel* _source = nullptr;
+    QHeaderView* _header;
+    QItemSelectionModel* _selection = nullptr;
+    std::vector<QMetaObject::Connection> _connections;
+    int _rowHeight = 0;
+    int _iconSize = 0;
+    QCache<std::uint64_t, row_t> _layouts;
+};
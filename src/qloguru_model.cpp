@@ -3,52 +3,142 @@
 #include <QFile>
 #include <QFont>
 #include <QIcon>
-#include <map>
+#include <algorithm>
 #include <array>
+#include <mutex>
+#include <utility>
 
+#include "qloguru_capture.hpp"
 #include "qloguru_model.hpp"
 
 namespace
 {
 
-static std::map<int, const char*> icon_names = {
-    {0, ":/res/info.png"},
-    {-1, ":/res/warn.png"},
-    {-2, ":/res/error.png"},
-    {-3, ":/res/critical.png"}
+enum class Column {
+    Level = 0,
+    Logger,
+    Time,
+    Elapsed,
+    Message,
+    File,
+    Line,
+    Last
 };
 
-static  std::map<int, const char*> level_names = {
-     {0, "Info"},
-    {-1, "Warning"},
-    {-2, "Error"},
-    {-3,"Critical"}
+static constexpr std::array<const char*, 7> column_names = {
+    "Level", "Logger", "Time", "Elapsed", "Message", "File", "Line"
 };
 
-enum class Column { Level = 0, Logger, Time, Elapsed, Message, Last };
+static constexpr std::int64_t nanosecondsPerMillisecond = 1000000;
+static constexpr double nanosecondsPerSecond = 1e9;
 
-static constexpr std::array<const char*, 5> column_names = {
-    "Level", "Logger","Elapsed", "Time", "Message"
-};
+// Enough for every cell of several screens worth of rows.
+static constexpr std::size_t defaultDisplayCacheCapacity = 16384;
+
+// Beyond this, the closest ranges of a style change are reported together.
+static constexpr std::size_t maxStyleRanges = 256;
+
+QString toQString(std::string_view text)
+{
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+// Merge the runs of rows across the smallest gaps until only count are left.
+std::vector<std::pair<int, int>> mergeRuns(
+    const std::vector<std::pair<int, int>>& runs, std::size_t count
+)
+{
+    std::vector<int> gaps;
+    gaps.reserve(runs.size() - 1);
+    for (std::size_t i = 1; i < runs.size(); ++i)
+        gaps.push_back(runs[ i ].first - runs[ i - 1 ].second);
+
+    // Every gap below the threshold is closed, and as many of those equal to
+    // it as needed.
+    std::size_t merges = runs.size() - count;
+    std::nth_element(gaps.begin(), gaps.begin() + (merges - 1), gaps.end());
+    int threshold = gaps[ merges - 1 ];
+    std::size_t belowThreshold =
+        std::count_if(gaps.begin(), gaps.end(), [ threshold ](int gap) {
+            return gap < threshold;
+        });
+    std::size_t equalMerges = merges - belowThreshold;
+
+    std::vector<std::pair<int, int>> result = { runs.front() };
+    for (std::size_t i = 1; i < runs.size(); ++i) {
+        int gap = runs[ i ].first - result.back().second;
+        bool isMerged = gap < threshold;
+        if (gap == threshold && equalMerges > 0) {
+            isMerged = true;
+            --equalMerges;
+        }
+
+        if (isMerged)
+            result.back().second = runs[ i ].second;
+        else
+            result.push_back(runs[ i ]);
+    }
+
+    return result;
+}
 
 } // namespace
 
 QLoguruModel::QLoguruModel(QObject* parent)
     : QAbstractListModel(parent)
+    , _displayCache(defaultDisplayCacheCapacity)
 {
 }
 
 void QLoguruModel::addEntry(entry_t entry)
 {
-    if (_maxEntries > 0 && _items.size() == _maxEntries) {
-        beginRemoveRows(QModelIndex(), 0, 0);
-        _items.pop_front();
+    addEntries(std::span<entry_t>(&entry, 1));
+}
+
+void QLoguruModel::addEntries(std::span<entry_t> entries)
+{
+    if (entries.empty())
+        return;
+
+    // Only the tail of the batch can survive the limit, the rest would be
+    // removed right after being inserted.
+    if (_maxEntries > 0 && entries.size() > _maxEntries.value())
+        entries = entries.last(_maxEntries.value());
+
+    // Make room for the whole batch with a single removal.
+    if (_maxEntries > 0 && _storage.size() + entries.size() > _maxEntries) {
+        std::size_t overflow =
+            _storage.size() + entries.size() - _maxEntries.value();
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        {
+            std::unique_lock lock(_storage.mutex());
+            _storage.popFront(overflow);
+        }
+        evictIndexes();
         endRemoveRows();
     }
 
-    beginInsertRows(QModelIndex(), rowCount(), rowCount());
+    int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + entries.size() - 1);
 
-    _items.push_back(std::move(entry));
+    {
+        std::unique_lock lock(_storage.mutex());
+        for (const auto& entry : entries) {
+            _storage.append(entry);
+
+            std::size_t row = _storage.size() - 1;
+            std::uint64_t id = _storage.firstId() + row;
+            _facets.append(id, _storage.level(row), _storage.loggerId(row));
+            if (_searchIndex)
+                _searchIndex->append(id, entry.message);
+        }
+    }
+    spill();
+
+    if (!_styleRules.empty()) {
+        for (std::size_t row = first; row < _storage.size(); ++row)
+            _styleRules.append(*this, row);
+    }
 
     endInsertRows();
 }
@@ -57,10 +147,14 @@ void QLoguruModel::setMaxEntries(std::optional<std::size_t> maxEntries)
 {
     _maxEntries = maxEntries;
     // Incase the new maximum is below the current amount of items.
-    if (_maxEntries > 0 && _items.size() > _maxEntries) {
-        std::size_t offset = _items.size() - _maxEntries.value();
+    if (_maxEntries > 0 && _storage.size() > _maxEntries) {
+        std::size_t offset = _storage.size() - _maxEntries.value();
         beginRemoveRows(QModelIndex(), 0, offset - 1);
-        _items.erase(_items.begin(), _items.begin() + offset);
+        {
+            std::unique_lock lock(_storage.mutex());
+            _storage.popFront(offset);
+        }
+        evictIndexes();
         endRemoveRows();
     }
 }
@@ -70,16 +164,131 @@ std::optional<std::size_t> QLoguruModel::getMaxEntries() const
     return _maxEntries;
 }
 
+bool QLoguruModel::saveCapture(const QString& path) const
+{
+    return QLoguruCapture::save(path, _storage);
+}
+
+bool QLoguruModel::loadCapture(const QString& path)
+{
+    QLoguruCapture capture;
+    if (!capture.open(path))
+        return false;
+
+    // Blocks entirely before the last maxEntries rows aren't read at all.
+    const std::vector<QLoguruCapture::block_t>& blocks = capture.blocks();
+    std::size_t firstBlock = 0;
+    std::size_t rows = capture.size();
+    while (_maxEntries > 0 && firstBlock < blocks.size() &&
+           rows - blocks[ firstBlock ].rows >= _maxEntries.value())
+        rows -= blocks[ firstBlock++ ].rows;
+
+    beginResetModel();
+
+    std::vector<std::uint32_t> loggerIds;
+    std::vector<std::uint32_t> fileIds;
+    {
+        std::unique_lock lock(_storage.mutex());
+        _storage.clear();
+        for (const std::string& name : capture.loggerNames())
+            loggerIds.push_back(_storage.loggerNames().intern(name));
+        for (const std::string& name : capture.fileNames())
+            fileIds.push_back(_storage.fileNames().intern(name));
+    }
+    evictIndexes();
+    _displayCache.clear();
+
+    bool isRead = true;
+    QLoguruStorage::columns_t columns;
+    for (std::size_t block = firstBlock; block < blocks.size(); ++block) {
+        isRead = capture.read(block, columns);
+        if (!isRead)
+            break;
+
+        for (std::uint32_t& id : columns.logger)
+            id = loggerIds[ id ];
+        for (std::uint32_t& id : columns.file)
+            id = fileIds[ id ];
+
+        std::size_t first = _storage.size();
+        {
+            std::unique_lock lock(_storage.mutex());
+            _storage.append(columns);
+        }
+        spill();
+
+        for (std::size_t row = first; row < _storage.size(); ++row) {
+            std::uint64_t id = _storage.firstId() + row;
+            _facets.append(id, _storage.level(row), _storage.loggerId(row));
+            if (_searchIndex)
+                _searchIndex->append(id, _storage.message(row));
+        }
+    }
+
+    if (_maxEntries > 0 && _storage.size() > _maxEntries) {
+        {
+            std::unique_lock lock(_storage.mutex());
+            _storage.popFront(_storage.size() - _maxEntries.value());
+        }
+        evictIndexes();
+    }
+
+    if (!_styleRules.empty()) {
+        for (std::size_t row = 0; row < _storage.size(); ++row)
+            _styleRules.append(*this, row);
+    }
+
+    endResetModel();
+    return isRead;
+}
+
+void QLoguruModel::setSpillDirectory(const QString& directory)
+{
+    std::unique_lock lock(_storage.mutex());
+    _storage.setSpillDirectory(directory);
+}
+
+QString QLoguruModel::getSpillDirectory() const
+{
+    return _storage.spillDirectory();
+}
+
+void QLoguruModel::spill()
+{
+    // The storage stops spilling on its own when a segment can't be written,
+    // its directory is only cleared then.
+    QString directory = _storage.spillDirectory();
+    _storage.spill();
+    if (!directory.isEmpty() && _storage.spillDirectory().isEmpty())
+        emit spillFailed(directory);
+}
+
+void QLoguruModel::setMemoryEntries(std::size_t count)
+{
+    std::unique_lock lock(_storage.mutex());
+    _storage.setMemoryRows(count);
+}
+
+std::size_t QLoguruModel::getMemoryEntries() const
+{
+    return _storage.memoryRows();
+}
+
 void QLoguruModel::clear()
 {
     beginResetModel();
-    _items.clear();
+    {
+        std::unique_lock lock(_storage.mutex());
+        _storage.clear();
+    }
+    evictIndexes();
+    _displayCache.clear();
     endResetModel();
 }
 
 int QLoguruModel::rowCount(const QModelIndex& parent) const
 {
-    return _items.size();
+    return static_cast<int>(_storage.size());
 }
 
 int QLoguruModel::columnCount(const QModelIndex& parent) const
@@ -89,30 +298,40 @@ int QLoguruModel::columnCount(const QModelIndex& parent) const
 
 QVariant QLoguruModel::data(const QModelIndex& index, int role) const
 {
-    if (!index.isValid() || index.row() >= _items.size())
+    if (!index.isValid() || index.row() >= _storage.size())
         return QVariant();
 
+    const std::size_t row = index.row();
+
     switch (role) {
         case Qt::DisplayRole: {
-            auto const& item = _items[ index.row() ];
             switch (static_cast<Column>(index.column())) {
                 case Column::Level: {
-                    return QString(level_names[ item.level ]);
+                    return _levels.name(_storage.level(row));
                 }
 
                 case Column::Logger: {
-                    return QString::fromStdString(item.loggerName);
+                    return nameString(
+                        _loggerStrings,
+                        _storage.loggerNames(),
+                        _storage.loggerId(row)
+                    );
                 }
-                case Column::Elapsed: {
-                    return QString::fromStdString(item.elapsed);
+
+                case Column::Elapsed:
+                case Column::Time:
+                case Column::Message: {
+                    return displayString(row, index.column());
                 }
 
-                case Column::Time: {
-                    return QString::fromStdString(item.time);
+                case Column::File: {
+                    return nameString(
+                        _fileStrings, _storage.fileNames(), _storage.fileId(row)
+                    );
                 }
 
-                case Column::Message: {
-                    return QString::fromStdString(item.message);
+                case Column::Line: {
+                    return _storage.line(row);
                 }
 
                 default: {
@@ -124,38 +343,44 @@ QVariant QLoguruModel::data(const QModelIndex& index, int role) const
         }
 
         case Qt::DecorationRole: {
-            if (index.column() == 0) {
-                const auto& item = _items[ index.row() ];
-                if (icon_names.count(_items[ index.row() ].level )) {
-                    return QIcon(
-                        QString(icon_names[ _items[ index.row() ].level ])
-                    );
-                }
-            }
+            if (index.column() == 0)
+                return _levels.icon(_storage.level(row));
 
             break;
         }
 
         case Qt::BackgroundRole: {
-            std::string loggerName = _items[ index.row() ].loggerName;
-            if (_backgroundMappings.contains(loggerName))
-                return _backgroundMappings.at(loggerName);
+            const QLoguruStyleRule* rule = rowRule(row);
+            if (rule && rule->background)
+                return rule->background.value();
+
+            const style_t* style = rowStyle(row);
+            if (style && style->background)
+                return style->background.value();
 
             break;
         }
 
         case Qt::ForegroundRole: {
-            std::string loggerName = _items[ index.row() ].loggerName;
-            if (_foregroundMappings.contains(loggerName))
-                return _foregroundMappings.at(loggerName);
+            const QLoguruStyleRule* rule = rowRule(row);
+            if (rule && rule->foreground)
+                return rule->foreground.value();
+
+            const style_t* style = rowStyle(row);
+            if (style && style->foreground)
+                return style->foreground.value();
 
             break;
         }
 
         case Qt::FontRole: {
-            std::string loggerName = _items[ index.row() ].loggerName;
-            if (_fontMappings.contains(loggerName))
-                return _fontMappings.at(loggerName);
+            const QLoguruStyleRule* rule = rowRule(row);
+            if (rule && rule->font)
+                return rule->font.value();
+
+            const style_t* style = rowStyle(row);
+            if (style && style->font)
+                return style->font.value();
 
             break;
         }
@@ -168,118 +393,282 @@ QVariant QLoguruModel::data(const QModelIndex& index, int role) const
     return QVariant();
 }
 
+QString QLoguruModel::nameString(
+    std::vector<std::optional<QString>>& cache,
+    const QLoguruStringTable& names,
+    std::uint32_t id
+) const
+{
+    // There are only a few distinct names, each is converted once and then
+    // shared by all the rows referring to it.
+    if (id >= cache.size())
+        cache.resize(names.size());
+
+    if (!cache[ id ])
+        cache[ id ] = toQString(names[ id ]);
+
+    return cache[ id ].value();
+}
+
+QString QLoguruModel::displayString(std::size_t row, int column) const
+{
+    auto key = QLoguruDisplayCache::key(_storage.firstId() + row, column);
+    if (const QString* cached = _displayCache.find(key))
+        return *cached;
+
+    QString result;
+    switch (static_cast<Column>(column)) {
+        case Column::Elapsed: {
+            result = QString("%1s").arg(
+                _storage.elapsed(row) / nanosecondsPerSecond, 0, 'f', 3
+            );
+            break;
+        }
+
+        case Column::Time: {
+            result = QDateTime::fromMSecsSinceEpoch(
+                         _storage.time(row) / nanosecondsPerMillisecond
+            )
+                         .toString("hh:mm:ss.zzz");
+            break;
+        }
+
+        case Column::Message: {
+            result = toQString(_storage.message(row));
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    _displayCache.insert(key, result);
+    return result;
+}
+
+void QLoguruModel::refreshLevelNames()
+{
+    _levels.refreshNames();
+    if (rowCount() > 0)
+        emit dataChanged(index(0), index(rowCount() - 1), { Qt::DisplayRole });
+}
+
+void QLoguruModel::setDisplayCacheCapacity(std::size_t capacity)
+{
+    _displayCache.setCapacity(capacity);
+}
+
+std::size_t QLoguruModel::getDisplayCacheCapacity() const
+{
+    return _displayCache.capacity();
+}
+
+void QLoguruModel::evictIndexes()
+{
+    _facets.evict(_storage.firstId());
+    if (_searchIndex)
+        _searchIndex->evict(_storage.firstId());
+    _styleRules.evict(_storage.firstId());
+}
+
+void QLoguruModel::setSearchIndexEnabled(bool enabled)
+{
+    if (!enabled) {
+        _searchIndex.reset();
+        return;
+    }
+
+    if (_searchIndex)
+        return;
+
+    // Index the rows already there, the new ones are added as they arrive.
+    _searchIndex = std::make_unique<QLoguruTrigramIndex>(_searchIndexMemoryLimit);
+    for (std::size_t row = 0; row < _storage.size(); ++row)
+        _searchIndex->append(_storage.firstId() + row, _storage.message(row));
+}
+
+void QLoguruModel::setSearchIndexMemoryLimit(std::size_t memoryLimit)
+{
+    _searchIndexMemoryLimit = memoryLimit;
+    if (_searchIndex)
+        _searchIndex->setMemoryLimit(memoryLimit);
+}
+
+std::size_t QLoguruModel::getSearchIndexMemoryLimit() const
+{
+    return _searchIndexMemoryLimit;
+}
+
 QVariant QLoguruModel::headerData(
     int section, Qt::Orientation orientation, int role
 ) const
 {
-    if (role == Qt::DisplayRole && orientation == Qt::Horizontal)
+    if (role == Qt::DisplayRole && orientation == Qt::Horizontal &&
+        section >= 0 && section < columnCount())
         return QString(column_names[ section ]);
 
     return QVariant();
 }
 
+std::uint32_t QLoguruModel::styledLogger(std::string_view loggerName)
+{
+    std::uint32_t id;
+    {
+        std::unique_lock lock(_storage.mutex());
+        id = _storage.loggerNames().intern(loggerName);
+    }
+    if (id >= _loggerStyles.size())
+        _loggerStyles.resize(id + 1);
+
+    return id;
+}
+
+const QLoguruModel::style_t* QLoguruModel::findLoggerStyle(
+    std::string_view loggerName
+) const
+{
+    std::uint32_t id = _storage.loggerNames().find(loggerName);
+    if (id >= _loggerStyles.size())
+        return nullptr;
+
+    return &_loggerStyles[ id ];
+}
+
+const QLoguruModel::style_t* QLoguruModel::rowStyle(std::size_t row) const
+{
+    std::uint32_t id = _storage.loggerId(row);
+    if (id >= _loggerStyles.size())
+        return nullptr;
+
+    return &_loggerStyles[ id ];
+}
+
+const QLoguruStyleRule* QLoguruModel::rowRule(std::size_t row) const
+{
+    return _styleRules.rule(_storage.firstId() + row);
+}
+
+void QLoguruModel::emitStyleChanged(
+    std::uint32_t loggerId, const QVector<int>& roles
+)
+{
+    const QLoguruBitmap* rows = _facets.logger(loggerId);
+    if (!rows || rows->empty())
+        return;
+
+    // Only the rows of the logger changed, as runs of consecutive rows.
+    std::vector<std::pair<int, int>> runs;
+    std::uint64_t firstId = _storage.firstId();
+    rows->forEach([ & ](std::uint64_t id) {
+        int row = static_cast<int>(id - firstId);
+        if (!runs.empty() && runs.back().second + 1 == row)
+            runs.back().second = row;
+        else
+            runs.emplace_back(row, row);
+    });
+
+    // Interleaved loggers make for many short runs, past a point the runs
+    // separated by the smallest gaps are merged, the rows of other loggers
+    // in between are reported as well.
+    if (runs.size() > maxStyleRanges)
+        runs = mergeRuns(runs, maxStyleRanges);
+
+    int lastColumn = std::max(0, columnCount() - 1);
+    for (auto [ first, last ] : runs)
+        emit dataChanged(index(first, 0), index(last, lastColumn), roles);
+}
+
 void QLoguruModel::setLoggerForeground(
     std::string_view loggerName, std::optional<QColor> color
 )
 {
-    int lastRow = this->rowCount() - 1;
-    if (lastRow < 0)
-        lastRow = 0;
-    int lastColumn = this->columnCount() - 1;
-    if (lastColumn < 0)
-        lastColumn = 0;
-    if (color.has_value()) {
-        _foregroundMappings[ std::string(loggerName) ] = color.value();
-        emit dataChanged(
-            this->index(0),
-            this->index(lastRow, lastColumn),
-            { Qt::ForegroundRole }
-        );
-    } else if (_foregroundMappings.contains(std::string(loggerName))) {
-        _foregroundMappings.erase(std::string(loggerName));
-        emit dataChanged(
-            this->index(0),
-            this->index(lastRow, lastColumn),
-            { Qt::ForegroundRole }
-        );
-    }
+    if (!color && !findLoggerStyle(loggerName))
+        return;
+
+    std::uint32_t id = styledLogger(loggerName);
+    _loggerStyles[ id ].foreground = color;
+    emitStyleChanged(id, { Qt::ForegroundRole });
 }
 
 std::optional<QColor> QLoguruModel::getLoggerForeground(
     std::string_view loggerName
 ) const
 {
-    if (_foregroundMappings.contains(std::string(loggerName)))
-        return _foregroundMappings.at(std::string(loggerName));
-
-    return std::nullopt;
+    const style_t* style = findLoggerStyle(loggerName);
+    return style ? style->foreground : std::nullopt;
 }
 
 void QLoguruModel::setLoggerBackground(
     std::string_view loggerName, std::optional<QBrush> brush
 )
 {
-    int lastRow = this->rowCount() - 1;
-    if (lastRow < 0)
-        lastRow = 0;
-    int lastColumn = this->columnCount() - 1;
-    if (lastColumn < 0)
-        lastColumn = 0;
-    if (brush.has_value()) {
-        _backgroundMappings[ std::string(loggerName) ] = brush.value();
-        emit dataChanged(
-            this->index(0),
-            this->index(lastRow, lastColumn),
-            { Qt::BackgroundRole }
-        );
-    } else if (_backgroundMappings.contains(std::string(loggerName))) {
-        _backgroundMappings.erase(std::string(loggerName));
-        emit dataChanged(
-            this->index(0),
-            this->index(lastRow, lastColumn),
-            { Qt::BackgroundRole }
-        );
-    }
+    if (!brush && !findLoggerStyle(loggerName))
+        return;
+
+    std::uint32_t id = styledLogger(loggerName);
+    _loggerStyles[ id ].background = brush;
+    emitStyleChanged(id, { Qt::BackgroundRole });
 }
 
 std::optional<QBrush> QLoguruModel::getLoggerBackground(
     std::string_view loggerName
 ) const
 {
-    if (_backgroundMappings.contains(std::string(loggerName)))
-        return _backgroundMappings.at(std::string(loggerName));
-
-    return std::nullopt;
+    const style_t* style = findLoggerStyle(loggerName);
+    return style ? style->background : std::nullopt;
 }
 
 void QLoguruModel::setLoggerFont(
     std::string_view loggerName, std::optional<QFont> font
 )
 {
-    int lastRow = this->rowCount() - 1;
-    if (lastRow < 0)
-        lastRow = 0;
-    int lastColumn = this->columnCount() - 1;
-    if (lastColumn < 0)
-        lastColumn = 0;
-    if (font.has_value()) {
-        _fontMappings[ std::string(loggerName) ] = font.value();
-        emit dataChanged(
-            this->index(0), this->index(lastRow, lastColumn), { Qt::FontRole }
-        );
-    } else if (_fontMappings.contains(std::string(loggerName))) {
-        _fontMappings.erase(std::string(loggerName));
-        emit dataChanged(
-            this->index(0), this->index(lastRow, lastColumn), { Qt::FontRole }
-        );
-    }
+    if (!font && !findLoggerStyle(loggerName))
+        return;
+
+    std::uint32_t id = styledLogger(loggerName);
+    _loggerStyles[ id ].font = font;
+    emitStyleChanged(id, { Qt::FontRole });
+}
+
+void QLoguruModel::setLoggerStyle(
+    std::string_view loggerName,
+    std::optional<QBrush> background,
+    std::optional<QColor> foreground,
+    std::optional<QFont> font
+)
+{
+    if (!background && !foreground && !font && !findLoggerStyle(loggerName))
+        return;
+
+    std::uint32_t id = styledLogger(loggerName);
+    _loggerStyles[ id ] = { std::move(background),
+                            std::move(foreground),
+                            std::move(font) };
+    emitStyleChanged(
+        id, { Qt::BackgroundRole, Qt::ForegroundRole, Qt::FontRole }
+    );
+}
+
+void QLoguruModel::setStyleRules(std::vector<QLoguruStyleRule> rules)
+{
+    if (rules == _styleRules.rules())
+        return;
+
+    _styleRules.setRules(std::move(rules), *this);
+    if (rowCount() == 0)
+        return;
+
+    emit dataChanged(
+        index(0),
+        index(rowCount() - 1, std::max(0, columnCount() - 1)),
+        { Qt::BackgroundRole, Qt::ForegroundRole, Qt::FontRole }
+    );
 }
 
 std::optional<QFont> QLoguruModel::getLoggerFont(std::string_view loggerName
 ) const
 {
-    if (_fontMappings.contains(std::string(loggerName)))
-        return _fontMappings.at(std::string(loggerName));
-
-    return std::nullopt;
-}
\ No newline at end of file
+    const style_t* style = findLoggerStyle(loggerName);
+    return style ? style->font : std::nullopt;
+}
@@ -1,33 +1,61 @@
 #pragma once
 
 #include <QAbstractListModel>
-#include <deque>
+#include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 #include <QFont>
 
+#include "qloguru_display_cache.hpp"
+#include "qloguru_facet_index.hpp"
+#include "qloguru_levels.hpp"
+#include "qloguru_storage.hpp"
+#include "qloguru_style_rules.hpp"
+#include "qloguru_trigram_index.hpp"
+
 class QLoguruModel : public QAbstractListModel
 {
 public:
     Q_OBJECT
 public:
-    struct entry_t {
-        std::string time;
-        std::string elapsed;
-        int level;
-        std::string message;
-        std::string loggerName;
-    };
+    using entry_t = QLoguruStorage::entry_t;
 
 public:
     QLoguruModel(QObject* parent = nullptr);
     ~QLoguruModel() override = default;
 
     void addEntry(entry_t entry);
+    void addEntries(std::span<entry_t> entries);
     void clear();
 
     void setMaxEntries(std::optional<std::size_t> maxEntries);
     std::optional<std::size_t> getMaxEntries() const;
 
+    bool saveCapture(const QString& path) const;
+    // Replaces the rows, those read before an error are kept.
+    bool loadCapture(const QString& path);
+
+    void setSpillDirectory(const QString& directory);
+    QString getSpillDirectory() const;
+    void setMemoryEntries(std::size_t count);
+    std::size_t getMemoryEntries() const;
+
+    const QLoguruStorage& storage() const { return _storage; }
+    const QLoguruLevels& levels() const { return _levels; }
+
+    void refreshLevelNames();
+
+    void setDisplayCacheCapacity(std::size_t capacity);
+    std::size_t getDisplayCacheCapacity() const;
+
+    void setSearchIndexEnabled(bool enabled);
+    bool isSearchIndexEnabled() const { return _searchIndex != nullptr; }
+    void setSearchIndexMemoryLimit(std::size_t memoryLimit);
+    std::size_t getSearchIndexMemoryLimit() const;
+    const QLoguruTrigramIndex* searchIndex() const { return _searchIndex.get(); }
+    const QLoguruFacetIndex& facetIndex() const { return _facets; }
+
     void setLoggerForeground(std::string_view loggerName, std::optional<QColor> color);
     std::optional<QColor> getLoggerForeground(std::string_view loggerName) const;
 
@@ -37,6 +65,20 @@ public:
     void setLoggerFont(std::string_view loggerName, std::optional<QFont> font);
     std::optional<QFont> getLoggerFont(std::string_view loggerName) const;
 
+    // Sets the three at once, with a single update of the rows.
+    void setLoggerStyle(
+        std::string_view loggerName,
+        std::optional<QBrush> background,
+        std::optional<QColor> foreground,
+        std::optional<QFont> font
+    );
+
+    void setStyleRules(std::vector<QLoguruStyleRule> rules);
+    const std::vector<QLoguruStyleRule>& getStyleRules() const
+    {
+        return _styleRules.rules();
+    }
+
 #pragma region QAbstractListModel
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -47,10 +89,44 @@ public:
     ) const override;
 #pragma endregion
 
+signals:
+    // Spilling stopped, the directory couldn't take another segment. The
+    // rows stay in memory from then on.
+    void spillFailed(const QString& directory);
+
+private:
+    struct style_t {
+        std::optional<QBrush> background;
+        std::optional<QColor> foreground;
+        std::optional<QFont> font;
+    };
+
+    std::uint32_t styledLogger(std::string_view loggerName);
+    const style_t* findLoggerStyle(std::string_view loggerName) const;
+    const style_t* rowStyle(std::size_t row) const;
+    const QLoguruStyleRule* rowRule(std::size_t row) const;
+    QString nameString(
+        std::vector<std::optional<QString>>& cache,
+        const QLoguruStringTable& names,
+        std::uint32_t id
+    ) const;
+    QString displayString(std::size_t row, int column) const;
+    void emitStyleChanged(std::uint32_t loggerId, const QVector<int>& roles);
+    void evictIndexes();
+    void spill();
+
 private:
-    std::deque<entry_t> _items;
+    QLoguruStorage _storage;
     std::optional<std::size_t> _maxEntries;
-    std::map<std::string, QBrush> _backgroundMappings;
-    std::map<std::string, QColor> _foregroundMappings;
-    std::map<std::string, QFont> _fontMappings;
+    // Indexed by the interned logger id.
+    std::vector<style_t> _loggerStyles;
+    // Converted names, indexed by the interned logger and file ids.
+    mutable std::vector<std::optional<QString>> _loggerStrings;
+    mutable std::vector<std::optional<QString>> _fileStrings;
+    mutable QLoguruDisplayCache _displayCache;
+    QLoguruFacetIndex _facets;
+    std::unique_ptr<QLoguruTrigramIndex> _searchIndex;
+    QLoguruStyleRules _styleRules;
+    std::size_t _searchIndexMemoryLimit = QLoguruTrigramIndex::defaultMemoryLimit;
+    QLoguruLevels _levels;
 };
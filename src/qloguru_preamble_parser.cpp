@@ -0,0 +1,141 @@
+#include "qloguru_preamble_parser.hpp"
+
+namespace
+{
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+// Check the text against a shape where 'd' stands for a digit and any other
+// character has to match as is.
+bool matchesShape(std::string_view text, std::string_view shape)
+{
+    if (text.size() < shape.size())
+        return false;
+
+    for (std::size_t i = 0; i < shape.size(); ++i) {
+        if (shape[ i ] == 'd' ? !isDigit(text[ i ]) : text[ i ] != shape[ i ])
+            return false;
+    }
+
+    return true;
+}
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && isSpace(text.front()))
+        text.remove_prefix(1);
+    while (!text.empty() && isSpace(text.back()))
+        text.remove_suffix(1);
+    return text;
+}
+
+void skipSpaces(std::string_view& text)
+{
+    while (!text.empty() && isSpace(text.front()))
+        text.remove_prefix(1);
+}
+
+constexpr std::string_view dateShape = "dddd-dd-dd";
+constexpr std::string_view timeShape = "dd:dd:dd.ddd";
+
+} // namespace
+
+bool QLoguruPreambleParser::parse(std::string_view text, preamble_t& result)
+{
+    result = preamble_t {};
+
+    skipSpaces(text);
+    if (matchesShape(text, dateShape)) {
+        result.date = text.substr(0, dateShape.size());
+        text.remove_prefix(dateShape.size());
+        skipSpaces(text);
+    }
+
+    if (matchesShape(text, timeShape)) {
+        result.time = text.substr(0, timeShape.size());
+        text.remove_prefix(timeShape.size());
+        skipSpaces(text);
+    }
+
+    // "(%8.3fs)"
+    if (!text.empty() && text.front() == '(') {
+        std::size_t end = text.find(')');
+        if (end == std::string_view::npos)
+            return false;
+
+        result.uptime = trim(text.substr(1, end - 1));
+        text.remove_prefix(end + 1);
+        skipSpaces(text);
+    }
+
+    // "[%-*s]", the name itself may contain spaces
+    if (!text.empty() && text.front() == '[') {
+        std::size_t end = text.find(']');
+        if (end == std::string_view::npos)
+            return false;
+
+        result.thread = trim(text.substr(1, end - 1));
+        text.remove_prefix(end + 1);
+        skipSpaces(text);
+    }
+
+    // "%*s:%-5u", right aligned file name followed by the line number
+    std::size_t tokenEnd = 0;
+    while (tokenEnd < text.size() && !isSpace(text[ tokenEnd ]) &&
+           text[ tokenEnd ] != '|')
+        ++tokenEnd;
+
+    std::string_view token = text.substr(0, tokenEnd);
+    std::size_t colon = token.rfind(':');
+    if (colon != std::string_view::npos && colon + 1 < token.size()) {
+        unsigned line = 0;
+        bool numeric = true;
+        for (char c : token.substr(colon + 1)) {
+            if (!isDigit(c)) {
+                numeric = false;
+                break;
+            }
+            line = line * 10 + static_cast<unsigned>(c - '0');
+        }
+
+        if (numeric) {
+            result.file = token.substr(0, colon);
+            result.line = line;
+            text.remove_prefix(tokenEnd);
+            skipSpaces(text);
+        }
+    }
+
+    // "%4s" followed by the optional "| "
+    std::size_t pipe = text.find('|');
+    result.verbosity = trim(text.substr(0, pipe));
+    if (result.verbosity.find(' ') != std::string_view::npos)
+        return false;
+
+    if (pipe == std::string_view::npos)
+        return true;
+
+    return trim(text.substr(pipe + 1)).empty();
+}
+
+std::int64_t QLoguruPreambleParser::toNanoseconds(std::string_view uptime)
+{
+    std::int64_t seconds = 0;
+    std::int64_t fraction = 0;
+    std::int64_t scale = 1000000000;
+    bool isFraction = false;
+    for (char c : uptime) {
+        if (c == '.') {
+            isFraction = true;
+        } else if (isDigit(c)) {
+            if (!isFraction)
+                seconds = seconds * 10 + (c - '0');
+            else if (scale > 1)
+                fraction += (c - '0') * (scale /= 10);
+        }
+    }
+
+    return seconds * 1000000000 + fraction;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Scanner for the preamble loguru prepends to every message, e.g.
+ *
+ *   2023-01-01 12:34:56.789 (   0.123s) [main thread     ]  main.cpp:42    INFO|
+ *
+ * Every part is optional (see loguru's g_preamble_* flags), so the parts are
+ * recognized by their shape rather than by their position. The scanner does
+ * not allocate, the parsed parts point into the given text.
+ */
+class QLoguruPreambleParser
+{
+public:
+    struct preamble_t {
+        std::string_view date;      // yyyy-mm-dd
+        std::string_view time;      // hh:mm:ss.zzz
+        std::string_view uptime;    // seconds, including the trailing 's'
+        std::string_view thread;    // thread name without the padding
+        std::string_view file;      // file name without the padding
+        unsigned line = 0;          // line number, 0 if missing
+        std::string_view verbosity; // verbosity name without the padding
+    };
+
+public:
+    /**
+     * @brief Parse the given preamble.
+     *
+     * @param text the preamble text
+     * @param result the parsed parts, parts that are missing stay empty
+     * @return true if the whole text was recognized
+     */
+    static bool parse(std::string_view text, preamble_t& result);
+
+    /**
+     * @brief Convert a parsed uptime, e.g. "123.456s", to nanoseconds.
+     */
+    static std::int64_t toNanoseconds(std::string_view uptime);
+};
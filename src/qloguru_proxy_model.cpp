@@ -1,8 +1,719 @@
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <shared_mutex>
+
 #include "qloguru_model.hpp"
 #include "qloguru_proxy_model.hpp"
 
+namespace
+{
+
+// Rebase the stored rows well before the offset could overflow.
+static constexpr std::uint32_t maxOffset = 1u << 30;
+
+// Smaller models are filtered synchronously, it's faster than the round trip
+// through the thread pool and the result is there right away.
+static constexpr int backgroundScanThreshold = 100000;
+
+// Rows scanned at once by a worker, also the granularity of the progress.
+static constexpr std::uint64_t scanBlockSize = 65536;
+
+// Rows read under a single shared lock. glibc's rwlock prefers readers, with
+// every worker holding it for a whole block the GUI thread could be kept from
+// appending for the whole scan.
+static constexpr std::uint64_t lockSliceSize = 4096;
+
+} // namespace
+
+struct QLoguruProxyModel::scan_t {
+    QLoguruFilter filter;
+    facet_filter_t facets;
+    // The rows passing the facets, only those are tested when given.
+    std::optional<QLoguruBitmap> rows;
+    std::uint64_t begin;
+    std::uint64_t end;
+    std::size_t blockCount;
+    std::atomic<std::size_t> nextBlock { 0 };
+    std::atomic<bool> cancelled { false };
+    std::vector<std::vector<std::uint64_t>> results;
+    std::unique_ptr<std::atomic<bool>[]> done;
+    // Only touched by the GUI thread.
+    std::size_t published = 0;
+};
+
 QLoguruProxyModel::QLoguruProxyModel(QObject* parent)
-    : QSortFilterProxyModel(parent)
+    : QAbstractProxyModel(parent)
+{
+}
+
+QLoguruProxyModel::~QLoguruProxyModel()
+{
+    cancelScan();
+    waitForWorkers();
+}
+
+void QLoguruProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    beginResetModel();
+    cancelScan();
+    waitForWorkers();
+
+    for (auto& connection : _connections)
+        disconnect(connection);
+    _connections.clear();
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+    _model = qobject_cast<QLoguruModel*>(sourceModel);
+
+    if (_model) {
+        _connections = {
+            connect(
+                _model,
+                &QAbstractItemModel::rowsInserted,
+                this,
+                &QLoguruProxyModel::sourceRowsInserted
+            ),
+            connect(
+                _model,
+                &QAbstractItemModel::rowsAboutToBeRemoved,
+                this,
+                &QLoguruProxyModel::sourceRowsAboutToBeRemoved
+            ),
+            connect(
+                _model,
+                &QAbstractItemModel::rowsRemoved,
+                this,
+                &QLoguruProxyModel::sourceRowsRemoved
+            ),
+            connect(
+                _model,
+                &QAbstractItemModel::dataChanged,
+                this,
+                &QLoguruProxyModel::sourceDataChanged
+            ),
+            connect(
+                _model,
+                &QAbstractItemModel::modelAboutToBeReset,
+                this,
+                &QLoguruProxyModel::sourceModelAboutToBeReset
+            ),
+            connect(
+                _model,
+                &QAbstractItemModel::modelReset,
+                this,
+                &QLoguruProxyModel::sourceModelReset
+            ),
+        };
+    }
+
+    refilter();
+    endResetModel();
+}
+
+void QLoguruProxyModel::setFilter(QLoguruFilter filter)
+{
+    if (filter == _filter)
+        return;
+
+    // The current matches are only a base for narrowing once complete.
+    bool narrows = !_scan && !_isIdentity && filter.isRefinementOf(_filter);
+    beginResetModel();
+    _filter = std::move(filter);
+    if (narrows)
+        narrow();
+    else
+        refilter();
+    endResetModel();
+}
+
+void QLoguruProxyModel::setFacets(Facets facets)
+{
+    if (facets == _facets)
+        return;
+
+    beginResetModel();
+    _facets = std::move(facets);
+    refilter();
+    endResetModel();
+}
+
+QModelIndex QLoguruProxyModel::mapToSource(const QModelIndex& proxyIndex) const
+{
+    if (!_model || !proxyIndex.isValid() ||
+        static_cast<std::size_t>(proxyIndex.row()) >= matchCount())
+        return QModelIndex();
+
+    int sourceRow = _isIdentity ? proxyIndex.row()
+                                : _rows[ _head + proxyIndex.row() ] - _offset;
+    return _model->index(sourceRow, proxyIndex.column());
+}
+
+QModelIndex QLoguruProxyModel::mapFromSource(const QModelIndex& sourceIndex
+) const
+{
+    if (!sourceIndex.isValid())
+        return QModelIndex();
+
+    if (_isIdentity)
+        return static_cast<std::size_t>(sourceIndex.row()) < _identityRows
+                   ? createIndex(sourceIndex.row(), sourceIndex.column())
+                   : QModelIndex();
+
+    std::size_t position = lowerBound(sourceIndex.row());
+    if (position >= _rows.size() ||
+        _rows[ position ] - _offset !=
+            static_cast<std::uint32_t>(sourceIndex.row()))
+        return QModelIndex();
+
+    return createIndex(
+        static_cast<int>(position - _head), sourceIndex.column()
+    );
+}
+
+QModelIndex QLoguruProxyModel::index(
+    int row, int column, const QModelIndex& parent
+) const
+{
+    if (parent.isValid() || row < 0 || column < 0 ||
+        static_cast<std::size_t>(row) >= matchCount() ||
+        column >= columnCount())
+        return QModelIndex();
+
+    return createIndex(row, column);
+}
+
+QModelIndex QLoguruProxyModel::parent(const QModelIndex& child) const
+{
+    return QModelIndex();
+}
+
+QVariant QLoguruProxyModel::headerData(
+    int section, Qt::Orientation orientation, int role
+) const
+{
+    // Columns are never filtered, the sections map one to one.
+    if (!_model || orientation != Qt::Horizontal)
+        return QVariant();
+
+    return _model->headerData(section, orientation, role);
+}
+
+int QLoguruProxyModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(matchCount());
+}
+
+int QLoguruProxyModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() || !_model ? 0 : _model->columnCount();
+}
+
+void QLoguruProxyModel::sourceRowsInserted(
+    const QModelIndex& parent, int first, int last
+)
+{
+    // The model only appends, anything else is handled by starting over.
+    if (first != _model->rowCount() - (last - first + 1)) {
+        beginResetModel();
+        refilter();
+        endResetModel();
+        return;
+    }
+
+    if (_isIdentity) {
+        beginInsertRows(QModelIndex(), first, last);
+        _identityRows += last - first + 1;
+        endInsertRows();
+        return;
+    }
+
+    // Loggers hidden by name may just have appeared.
+    if (_facetFilter.isActive &&
+        _model->storage().loggerNames().size() > _facetFilter.loggers.size())
+        prepareFacets();
+
+    // Matches must stay ordered, the ones among the new rows are published
+    // after the ones the scan is still looking for.
+    if (_scan) {
+        std::uint64_t firstId = _model->storage().firstId();
+        for (int row = first; row <= last; ++row) {
+            if (accepts(row))
+                _pendingIds.push_back(firstId + row);
+        }
+        return;
+    }
+
+    // Only the new rows are evaluated.
+    std::vector<std::uint32_t> matches;
+    for (int row = first; row <= last; ++row) {
+        if (accepts(row))
+            matches.push_back(static_cast<std::uint32_t>(row) + _offset);
+    }
+
+    if (matches.empty())
+        return;
+
+    int proxyFirst = static_cast<int>(matchCount());
+    beginInsertRows(
+        QModelIndex(),
+        proxyFirst,
+        proxyFirst + static_cast<int>(matches.size()) - 1
+    );
+    _rows.insert(_rows.end(), matches.begin(), matches.end());
+    endInsertRows();
+}
+
+void QLoguruProxyModel::sourceRowsAboutToBeRemoved(
+    const QModelIndex& parent, int first, int last
+)
 {
-    setFilterKeyColumn(-1);
+    if (first != 0) {
+        _pendingReset = true;
+        beginResetModel();
+        return;
+    }
+
+    // Evicting from the front only drops the matches at the front.
+    _pendingRemoval = lowerBound(last + 1) - _head;
+    if (_pendingRemoval > 0)
+        beginRemoveRows(
+            QModelIndex(), 0, static_cast<int>(_pendingRemoval) - 1
+        );
+}
+
+void QLoguruProxyModel::sourceRowsRemoved(
+    const QModelIndex& parent, int first, int last
+)
+{
+    if (_pendingReset) {
+        _pendingReset = false;
+        refilter();
+        endResetModel();
+        return;
+    }
+
+    if (_isIdentity) {
+        _identityRows -= _pendingRemoval;
+    } else {
+        _head += _pendingRemoval;
+        _offset += static_cast<std::uint32_t>(last - first + 1);
+        compact();
+    }
+
+    if (_pendingRemoval > 0) {
+        _pendingRemoval = 0;
+        endRemoveRows();
+    }
+}
+
+void QLoguruProxyModel::sourceDataChanged(
+    const QModelIndex& topLeft,
+    const QModelIndex& bottomRight,
+    const QVector<int>& roles
+)
+{
+    // A changed text may change what matches.
+    if (!_filter.isEmpty() &&
+        (roles.isEmpty() || roles.contains(Qt::DisplayRole))) {
+        beginResetModel();
+        refilter();
+        endResetModel();
+        return;
+    }
+
+    std::size_t first = lowerBound(topLeft.row());
+    std::size_t last = lowerBound(bottomRight.row() + 1);
+    if (first >= last)
+        return;
+
+    emit dataChanged(
+        createIndex(static_cast<int>(first - _head), topLeft.column()),
+        createIndex(static_cast<int>(last - 1 - _head), bottomRight.column()),
+        roles
+    );
+}
+
+void QLoguruProxyModel::sourceModelAboutToBeReset()
+{
+    cancelScan();
+    beginResetModel();
+}
+
+void QLoguruProxyModel::sourceModelReset()
+{
+    refilter();
+    endResetModel();
+}
+
+bool QLoguruProxyModel::accepts(std::size_t row) const
+{
+    return _facetFilter.accepts(_model->storage(), row) &&
+           _filter.accepts(*_model, row);
+}
+
+void QLoguruProxyModel::prepareFacets()
+{
+    _facetFilter.levels.fill(true);
+    _facetFilter.loggers.clear();
+    _facetFilter.isActive = false;
+
+    for (std::size_t i = 0; i < QLoguruLevels::count; ++i) {
+        _facetFilter.levels[ i ] = !_facets.hiddenLevels[ i ];
+        _facetFilter.isActive |= _facets.hiddenLevels[ i ];
+    }
+
+    const QLoguruStringTable& loggers = _model->storage().loggerNames();
+    _facetFilter.loggers.assign(loggers.size(), true);
+    for (const std::string& name : _facets.hiddenLoggers) {
+        std::uint32_t id = loggers.find(name);
+        if (id == QLoguruStringTable::npos)
+            continue;
+
+        _facetFilter.loggers[ id ] = false;
+        _facetFilter.isActive = true;
+    }
+}
+
+bool QLoguruProxyModel::facet_filter_t::accepts(
+    const QLoguruStorage& storage, std::size_t row
+) const
+{
+    if (!isActive)
+        return true;
+
+    std::uint32_t logger = storage.loggerId(row);
+    return levels[ QLoguruLevels::index(storage.level(row)) ] &&
+           (logger >= loggers.size() || loggers[ logger ]);
+}
+
+void QLoguruProxyModel::refilter()
+{
+    cancelScan();
+
+    _rows.clear();
+    _head = 0;
+    _offset = 0;
+    _isIdentity = false;
+    _identityRows = 0;
+
+    if (!_model)
+        return;
+
+    _baseId = _model->storage().firstId();
+
+    // Start over with empty caches, the names may have changed as well.
+    _filter = QLoguruFilter(
+        _filter.text(), _filter.isRegularExpression(), _filter.isCaseSensitive()
+    );
+
+    prepareFacets();
+
+    int count = _model->rowCount();
+    if (_filter.isEmpty() && _facets == Facets()) {
+        // Releases the memory of the previous matches as well.
+        _rows.shrink_to_fit();
+        _isIdentity = true;
+        _identityRows = static_cast<std::size_t>(count);
+        emit filterProgress(count, count);
+        return;
+    }
+
+    if (_facetFilter.isActive) {
+        QLoguruBitmap rows = _model->facetIndex().select(
+            _facetFilter.levels, _facetFilter.loggers
+        );
+        // Too many rows left for the filter, the background scan only tests
+        // these.
+        if (!_filter.isEmpty() &&
+            rows.cardinality() >=
+                static_cast<std::size_t>(backgroundScanThreshold)) {
+            startScan(std::move(rows));
+            return;
+        }
+
+        refilterWithFacets(rows);
+        emit filterProgress(count, count);
+        return;
+    }
+
+    if (!_filter.isEmpty() && refilterWithIndex()) {
+        emit filterProgress(count, count);
+        return;
+    }
+
+    if (!_filter.isEmpty() && count >= backgroundScanThreshold) {
+        startScan();
+        return;
+    }
+
+    for (int row = 0; row < count; ++row) {
+        if (accepts(row))
+            _rows.push_back(static_cast<std::uint32_t>(row));
+    }
+
+    emit filterProgress(count, count);
+}
+
+void QLoguruProxyModel::refilterWithFacets(const QLoguruBitmap& rows)
+{
+    std::uint64_t firstId = _model->storage().firstId();
+    _rows.reserve(rows.cardinality());
+    rows.forEach([ & ](std::uint64_t id) {
+        std::size_t row = id - firstId;
+        if (_filter.accepts(*_model, row))
+            _rows.push_back(static_cast<std::uint32_t>(row));
+    });
+}
+
+bool QLoguruProxyModel::refilterWithIndex()
+{
+    const QLoguruTrigramIndex* index = _model->searchIndex();
+    if (!index)
+        return false;
+
+    std::string literal = _filter.requiredLiteral();
+    if (literal.empty())
+        return false;
+
+    // Rows matching on a name or a number don't need to contain the
+    // literal.
+    _filter.prepare(*_model);
+    if (_filter.matchesAnyName())
+        return false;
+
+    auto blocks = index->candidateBlocks(literal);
+    if (!blocks)
+        return false;
+
+    // The rows the index doesn't cover are checked one by one, if that's a
+    // lot the background scan is the better choice.
+    const QLoguruStorage& storage = _model->storage();
+    std::uint64_t firstId = storage.firstId();
+    std::uint64_t endId = firstId + storage.size();
+    std::uint64_t coveredFirst = std::clamp(index->firstId(), firstId, endId);
+    std::uint64_t coveredEnd = std::clamp(index->endId(), coveredFirst, endId);
+    std::uint64_t work = (coveredFirst - firstId) + (endId - coveredEnd) +
+                         blocks->size() * QLoguruTrigramIndex::blockSize;
+    if (work >= static_cast<std::uint64_t>(backgroundScanThreshold))
+        return false;
+
+    auto check = [ & ](std::uint64_t begin, std::uint64_t end) {
+        for (std::uint64_t id = begin; id < end; ++id) {
+            if (accepts(id - firstId))
+                _rows.push_back(static_cast<std::uint32_t>(id - firstId));
+        }
+    };
+
+    check(firstId, coveredFirst);
+    for (std::uint32_t block : *blocks) {
+        std::uint64_t begin = block * QLoguruTrigramIndex::blockSize;
+        check(
+            std::max(begin, coveredFirst),
+            std::min(begin + QLoguruTrigramIndex::blockSize, coveredEnd)
+        );
+    }
+    check(coveredEnd, endId);
+
+    return true;
+}
+
+void QLoguruProxyModel::startScan(std::optional<QLoguruBitmap> rows)
+{
+    const QLoguruStorage& storage = _model->storage();
+
+    auto scan = std::make_shared<scan_t>();
+    _filter.prepare(*_model);
+    scan->filter = _filter;
+    scan->facets = _facetFilter;
+    scan->rows = std::move(rows);
+    scan->begin = storage.firstId();
+    scan->end = storage.firstId() + storage.size();
+    scan->blockCount =
+        (scan->end - scan->begin + scanBlockSize - 1) / scanBlockSize;
+    scan->results.resize(scan->blockCount);
+    scan->done = std::make_unique<std::atomic<bool>[]>(scan->blockCount);
+    _scan = scan;
+
+    const QLoguruModel* model = _model;
+    auto work = [ this, scan, model ]() {
+        // Every worker has its own copy, the caches are not shared.
+        QLoguruFilter filter = scan->filter;
+        const QLoguruStorage& storage = model->storage();
+
+        for (;;) {
+            std::size_t block = scan->nextBlock.fetch_add(1);
+            if (block >= scan->blockCount ||
+                scan->cancelled.load(std::memory_order_relaxed))
+                break;
+
+            std::uint64_t begin = scan->begin + block * scanBlockSize;
+            std::uint64_t end = std::min(begin + scanBlockSize, scan->end);
+            std::vector<std::uint64_t>& result = scan->results[ block ];
+            for (std::uint64_t slice = begin; slice < end;
+                 slice += lockSliceSize) {
+                // The lock is released between slices, the GUI thread
+                // appending rows doesn't wait for the whole block. Rows may
+                // have been evicted meanwhile, ids stay valid though.
+                std::shared_lock lock(storage.mutex());
+                std::uint64_t firstId = storage.firstId();
+                std::uint64_t endId = firstId + storage.size();
+                std::uint64_t sliceBegin = std::max(slice, firstId);
+                std::uint64_t sliceEnd =
+                    std::min({ slice + lockSliceSize, end, endId });
+
+                // The rows of the bitmap already passed the facets.
+                if (scan->rows) {
+                    scan->rows->forEachIn(
+                        sliceBegin, sliceEnd, [ & ](std::uint64_t id) {
+                        if (filter.accepts(*model, id - firstId))
+                            result.push_back(id);
+                        }
+                    );
+                    continue;
+                }
+
+                for (std::uint64_t id = sliceBegin; id < sliceEnd; ++id) {
+                    std::size_t row = id - firstId;
+                    if (scan->facets.accepts(storage, row) &&
+                        filter.accepts(*model, row))
+                        result.push_back(id);
+                }
+            }
+
+            scan->done[ block ].store(true, std::memory_order_release);
+            QMetaObject::invokeMethod(
+                this, [ this ]() { publishScan(); }, Qt::QueuedConnection
+            );
+        }
+
+        std::lock_guard lock(_workersMutex);
+        if (--_workers == 0)
+            _workersFinished.notify_all();
+    };
+
+    int workerCount = std::max(
+        1,
+        std::min(QThread::idealThreadCount(), static_cast<int>(scan->blockCount))
+    );
+    for (int i = 0; i < workerCount; ++i) {
+        {
+            std::lock_guard lock(_workersMutex);
+            ++_workers;
+        }
+        QThreadPool::globalInstance()->start(work);
+    }
+
+    emit filterProgress(0, scan->end - scan->begin);
+}
+
+void QLoguruProxyModel::cancelScan()
+{
+    if (!_scan)
+        return;
+
+    // The workers notice on their next block, their results are ignored.
+    _scan->cancelled.store(true, std::memory_order_relaxed);
+    _scan.reset();
+    _pendingIds.clear();
+}
+
+void QLoguruProxyModel::publishScan()
+{
+    if (!_scan)
+        return;
+
+    // Publish the finished blocks in order, a slow block holds back the ones
+    // after it.
+    std::vector<std::uint64_t> ids;
+    while (_scan->published < _scan->blockCount &&
+           _scan->done[ _scan->published ].load(std::memory_order_acquire)) {
+        auto& result = _scan->results[ _scan->published ];
+        ids.insert(ids.end(), result.begin(), result.end());
+        result = {};
+        ++_scan->published;
+    }
+
+    qint64 total = _scan->end - _scan->begin;
+    qint64 scanned = std::min<qint64>(_scan->published * scanBlockSize, total);
+    bool finished = _scan->published == _scan->blockCount;
+
+    if (finished) {
+        ids.insert(ids.end(), _pendingIds.begin(), _pendingIds.end());
+        _pendingIds.clear();
+        _scan.reset();
+    }
+
+    appendIds(ids);
+    emit filterProgress(scanned, total);
+}
+
+void QLoguruProxyModel::appendIds(const std::vector<std::uint64_t>& ids)
+{
+    // Skip whatever got evicted while the ids waited to be published.
+    std::uint64_t firstId = _model->storage().firstId();
+    auto begin = std::lower_bound(ids.begin(), ids.end(), firstId);
+    if (begin == ids.end())
+        return;
+
+    int proxyFirst = static_cast<int>(matchCount());
+    beginInsertRows(
+        QModelIndex(),
+        proxyFirst,
+        proxyFirst + static_cast<int>(ids.end() - begin) - 1
+    );
+    for (auto it = begin; it != ids.end(); ++it)
+        _rows.push_back(static_cast<std::uint32_t>(*it - _baseId));
+    endInsertRows();
+}
+
+void QLoguruProxyModel::waitForWorkers()
+{
+    std::unique_lock lock(_workersMutex);
+    _workersFinished.wait(lock, [ this ]() { return _workers == 0; });
+}
+
+void QLoguruProxyModel::narrow()
+{
+    if (!_model)
+        return;
+
+    // The new matches are a subset of the current ones, only those need to
+    // be looked at again. Filtering in place keeps the order.
+    auto end = std::remove_if(
+        _rows.begin() + _head,
+        _rows.end(),
+        [ this ](std::uint32_t row) {
+        return !_filter.accepts(*_model, row - _offset);
+        }
+    );
+    _rows.erase(end, _rows.end());
+    compact();
+}
+
+void QLoguruProxyModel::compact()
+{
+    // Keep the dead prefix from growing forever, amortized over the
+    // evictions that created it.
+    if (_head > 0 && _head >= _rows.size() / 2) {
+        _rows.erase(_rows.begin(), _rows.begin() + _head);
+        _head = 0;
+    }
+
+    if (_offset >= maxOffset) {
+        for (std::uint32_t& row : _rows)
+            row -= _offset;
+        _baseId += _offset;
+        _offset = 0;
+    }
+}
+
+std::size_t QLoguruProxyModel::lowerBound(int sourceRow) const
+{
+    if (_isIdentity)
+        return std::min(static_cast<std::size_t>(sourceRow), _identityRows);
+
+    auto value = static_cast<std::uint32_t>(sourceRow) + _offset;
+    return std::lower_bound(_rows.begin() + _head, _rows.end(), value) -
+           _rows.begin();
 }
@@ -1,11 +1,163 @@
 #pragma once
 
-#include <QSortFilterProxyModel>
+#include <QAbstractProxyModel>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
 
-class QLoguruProxyModel : public QSortFilterProxyModel
+#include "qloguru_bitmap.hpp"
+#include "qloguru_filter.hpp"
+#include "qloguru_levels.hpp"
+
+class QLoguruModel;
+class QLoguruStorage;
+
+/**
+ * Filtering proxy specialized for the append-only QLoguruModel.
+ *
+ * The proxy keeps the sorted list of matching source rows. Appended source
+ * rows are the only ones evaluated on insertion, and evicting rows from the
+ * front of the source only moves the start of the list and bumps an offset
+ * instead of remapping the remaining rows.
+ *
+ * Re-filtering a large model runs on the global thread pool. The rows are
+ * split into blocks scanned in parallel, the matches of every finished block
+ * are published right away (in order) and a newer filter cancels the scan in
+ * flight. When the source model has a search index, filters with a required
+ * literal only check the rows of the blocks the index points to.
+ *
+ * On top of the filter whole levels and loggers can be hidden. The rows of
+ * the visible ones are taken straight from the bitmaps of the source model,
+ * so toggling them doesn't evaluate any row the filter doesn't have to.
+ */
+class QLoguruProxyModel : public QAbstractProxyModel
 {
     Q_OBJECT
 
+public:
+    struct Facets {
+        // Indexed by QLoguruLevels::index().
+        std::array<bool, QLoguruLevels::count> hiddenLevels {};
+        std::vector<std::string> hiddenLoggers;
+
+        bool operator==(const Facets& other) const = default;
+    };
+
 public:
     QLoguruProxyModel(QObject* parent = nullptr);
+    ~QLoguruProxyModel() override;
+
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+
+    void setFilter(QLoguruFilter filter);
+    const QLoguruFilter& filter() const { return _filter; }
+
+    void setFacets(Facets facets);
+    const Facets& facets() const { return _facets; }
+
+    /**
+     * @brief Check whether a background scan is in progress.
+     */
+    bool isFiltering() const { return _scan != nullptr; }
+
+#pragma region QAbstractProxyModel
+    QModelIndex mapToSource(const QModelIndex& proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex& sourceIndex) const override;
+    QModelIndex index(
+        int row, int column, const QModelIndex& parent = QModelIndex()
+    ) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    QVariant headerData(
+        int section, Qt::Orientation orientation, int role = Qt::DisplayRole
+    ) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+#pragma endregion
+
+signals:
+    void filterProgress(qint64 scanned, qint64 total);
+
+private slots:
+    void sourceRowsInserted(const QModelIndex& parent, int first, int last);
+    void sourceRowsAboutToBeRemoved(
+        const QModelIndex& parent, int first, int last
+    );
+    void sourceRowsRemoved(const QModelIndex& parent, int first, int last);
+    void sourceDataChanged(
+        const QModelIndex& topLeft,
+        const QModelIndex& bottomRight,
+        const QVector<int>& roles
+    );
+    void sourceModelAboutToBeReset();
+    void sourceModelReset();
+
+private:
+    struct scan_t;
+
+    // Facets resolved against the source model, cheap to check per row and
+    // safe to copy to the scan workers.
+    struct facet_filter_t {
+        bool isActive = false;
+        std::array<bool, QLoguruLevels::count> levels {};
+        std::vector<bool> loggers;
+
+        bool accepts(const QLoguruStorage& storage, std::size_t row) const;
+    };
+
+    bool accepts(std::size_t row) const;
+    void prepareFacets();
+    void refilterWithFacets(const QLoguruBitmap& rows);
+
+    void refilter();
+    bool refilterWithIndex();
+    void narrow();
+    void compact();
+    std::size_t matchCount() const
+    {
+        return _isIdentity ? _identityRows : _rows.size() - _head;
+    }
+    std::size_t lowerBound(int sourceRow) const;
+    void appendIds(const std::vector<std::uint64_t>& ids);
+
+    void startScan(std::optional<QLoguruBitmap> rows = std::nullopt);
+    void cancelScan();
+    void publishScan();
+    void waitForWorkers();
+
+private:
+    QLoguruModel* _model = nullptr;
+    QLoguruFilter _filter;
+    Facets _facets;
+    facet_filter_t _facetFilter;
+    std::vector<QMetaObject::Connection> _connections;
+
+    // Without filter nor facets every row matches, the rows aren't stored
+    // and a proxy row is the source row, up to _identityRows.
+    bool _isIdentity = false;
+    std::size_t _identityRows = 0;
+
+    // Matching source rows shifted by _offset, the live part starts at _head.
+    // A stored value plus _baseId is the absolute id of the row.
+    std::vector<std::uint32_t> _rows;
+    std::size_t _head = 0;
+    std::uint32_t _offset = 0;
+    std::uint64_t _baseId = 0;
+
+    // Background scan in flight and the matches among the rows appended
+    // meanwhile, published once the scan is done to keep the order.
+    std::shared_ptr<scan_t> _scan;
+    std::vector<std::uint64_t> _pendingIds;
+    int _workers = 0;
+    std::mutex _workersMutex;
+    std::condition_variable _workersFinished;
+
+    // State carried between the about-to-be-removed and removed signals.
+    std::size_t _pendingRemoval = 0;
+    bool _pendingReset = false;
 };
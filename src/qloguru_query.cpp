@@ -0,0 +1,388 @@
+#include <QDateTime>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTime>
+#include <algorithm>
+#include <optional>
+
+#include "qloguru_model.hpp"
+#include "qloguru_query.hpp"
+
+namespace
+{
+
+static constexpr std::int64_t nanosecondsPerMillisecond = 1000000;
+
+QString toQString(std::string_view text)
+{
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+// Splits on whitespace outside of double quotes, the quotes are kept.
+QStringList splitTerms(const QString& text)
+{
+    QStringList terms;
+    QString term;
+    bool quoted = false;
+    for (QChar c : text) {
+        if (c == '"')
+            quoted = !quoted;
+
+        if (c.isSpace() && !quoted) {
+            if (!term.isEmpty())
+                terms << term;
+            term.clear();
+        } else
+            term += c;
+    }
+
+    if (!term.isEmpty())
+        terms << term;
+
+    return terms;
+}
+
+QString unquote(const QString& text)
+{
+    if (text.size() >= 2 && text.startsWith('"') && text.endsWith('"'))
+        return text.mid(1, text.size() - 2);
+
+    return text;
+}
+
+std::optional<int> parseLevel(const QString& value)
+{
+    bool ok = false;
+    int level = value.toInt(&ok);
+    if (ok)
+        return level;
+
+    static const std::pair<const char*, int> aliases[] = {
+        { "fatal", -3 }, { "critical", -3 }, { "fatl", -3 }, { "error", -2 },
+        { "err", -2 },   { "warning", -1 },  { "warn", -1 }, { "info", 0 },
+        { "debug", 1 },  { "verbose", 1 },   { "trace", 2 },
+    };
+    for (const auto& [ name, alias ] : aliases) {
+        if (value.compare(name, Qt::CaseInsensitive) == 0)
+            return alias;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<std::int64_t> parseDuration(const QString& value)
+{
+    static const QRegularExpression pattern(
+        R"(^(\d+(?:\.\d*)?|\.\d+)(ns|us|ms|s|m|min|h)?$)"
+    );
+    QRegularExpressionMatch match = pattern.match(value);
+    if (!match.hasMatch())
+        return std::nullopt;
+
+    static const std::pair<const char*, double> units[] = {
+        { "ns", 1 },       { "us", 1e3 },     { "ms", 1e6 },   { "s", 1e9 },
+        { "", 1e9 },       { "m", 60e9 },     { "min", 60e9 }, { "h", 3600e9 },
+    };
+    double number = match.captured(1).toDouble();
+    for (const auto& [ unit, factor ] : units) {
+        if (match.captured(2) == unit)
+            return static_cast<std::int64_t>(number * factor);
+    }
+
+    return std::nullopt;
+}
+
+} // namespace
+
+QLoguruQuery::QLoguruQuery(const QString& text, bool isCaseSensitive)
+{
+    QStringList freeTerms;
+    for (const QString& term : splitTerms(text)) {
+        if (!parseTerm(term, isCaseSensitive))
+            freeTerms << unquote(term);
+
+        if (!_errorString.isEmpty())
+            return;
+    }
+
+    // Without predicates the text is left exactly as it was typed.
+    if (_predicates.empty()) {
+        _freeText = text;
+        return;
+    }
+
+    // Searched as one text, the same as without the predicates.
+    _freeText = freeTerms.join(' ');
+
+    // The fields are declared from the cheapest to the most expensive one.
+    std::stable_sort(
+        _predicates.begin(),
+        _predicates.end(),
+        [](const predicate_t& a, const predicate_t& b) {
+            return a.field < b.field;
+        }
+    );
+}
+
+bool QLoguruQuery::accepts(const QLoguruModel& model, std::size_t row) const
+{
+    for (const predicate_t& predicate : _predicates) {
+        if (!accepts(predicate, model, row))
+            return false;
+    }
+    return true;
+}
+
+void QLoguruQuery::prepare(const QLoguruModel& model) const
+{
+    const QLoguruStorage& storage = model.storage();
+    for (const predicate_t& predicate : _predicates) {
+        const QLoguruStringTable* names = nullptr;
+        if (predicate.field == Field::Logger)
+            names = &storage.loggerNames();
+        else if (predicate.field == Field::File)
+            names = &storage.fileNames();
+        else
+            continue;
+
+        for (std::uint32_t id = 0; id < names->size(); ++id)
+            nameMatches(predicate, *names, id);
+    }
+}
+
+std::string QLoguruQuery::requiredLiteral() const
+{
+    std::string result;
+    for (const predicate_t& predicate : _predicates) {
+        if (predicate.field != Field::Message || predicate.op != Op::Contains)
+            continue;
+
+        // Unicode case folding may match other bytes.
+        if (!predicate.search.isCaseSensitive() && !predicate.search.isAscii())
+            continue;
+
+        if (predicate.utf8.size() > result.size())
+            result = predicate.utf8;
+    }
+    return result;
+}
+
+bool QLoguruQuery::parseTerm(const QString& term, bool isCaseSensitive)
+{
+    static const QRegularExpression pattern(
+        R"(^([A-Za-z]+)(!=|>=|<=|:|=|>|<)(.*)$)"
+    );
+    QRegularExpressionMatch match = pattern.match(term);
+    if (!match.hasMatch())
+        return false;
+
+    static const std::pair<const char*, Field> fields[] = {
+        { "level", Field::Level },     { "lvl", Field::Level },
+        { "logger", Field::Logger },   { "thread", Field::Logger },
+        { "file", Field::File },       { "line", Field::Line },
+        { "elapsed", Field::Elapsed }, { "uptime", Field::Elapsed },
+        { "time", Field::Time },       { "msg", Field::Message },
+        { "message", Field::Message },
+    };
+    QString name = match.captured(1).toLower();
+    auto field = std::find_if(
+        std::begin(fields),
+        std::end(fields),
+        [ & ](const auto& entry) { return name == entry.first; }
+    );
+    // Anything else is just text which happens to contain an operator.
+    if (field == std::end(fields))
+        return false;
+
+    static const std::pair<const char*, Op> ops[] = {
+        { ":", Op::Contains },  { "=", Op::Equal },     { "!=", Op::NotEqual },
+        { "<", Op::Less },      { "<=", Op::LessEqual }, { ">", Op::Greater },
+        { ">=", Op::GreaterEqual },
+    };
+    QString opText = match.captured(2);
+    auto op = std::find_if(
+        std::begin(ops),
+        std::end(ops),
+        [ & ](const auto& entry) { return opText == entry.first; }
+    );
+
+    predicate_t predicate;
+    predicate.field = field->second;
+    predicate.op = op->second;
+    predicate.caseSensitivity =
+        isCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+    bool isText = predicate.field == Field::Logger ||
+                  predicate.field == Field::File ||
+                  predicate.field == Field::Message;
+    if (isText && predicate.op > Op::NotEqual) {
+        _errorString =
+            QString("'%1' can't be compared with '%2'").arg(name, opText);
+        return true;
+    }
+
+    // Contains means equals for everything but text.
+    if (!isText && predicate.op == Op::Contains)
+        predicate.op = Op::Equal;
+
+    QString value = unquote(match.captured(3));
+    if (value.isEmpty()) {
+        _errorString = QString("Missing value for '%1'").arg(name);
+        return true;
+    }
+
+    if (!parseValue(predicate, value)) {
+        _errorString = QString("Invalid value for '%1': %2").arg(name, value);
+        return true;
+    }
+
+    _predicates.push_back(std::move(predicate));
+    return true;
+}
+
+bool QLoguruQuery::parseValue(predicate_t& predicate, const QString& value)
+{
+    switch (predicate.field) {
+        case Field::Level: {
+            std::optional<int> level = parseLevel(value);
+            if (!level)
+                return false;
+
+            // Levels compare by severity, which goes the other way than the
+            // verbosity.
+            predicate.number = -level.value();
+            for (std::size_t i = 0; i < QLoguruLevels::count; ++i) {
+                int verbosity = static_cast<int>(i) + QLoguruLevels::minLevel;
+                predicate.levels[ i ] = compare(predicate, -verbosity);
+            }
+            return true;
+        }
+        case Field::Line: {
+            bool ok = false;
+            predicate.number = value.toLongLong(&ok);
+            return ok;
+        }
+        case Field::Elapsed: {
+            std::optional<std::int64_t> duration = parseDuration(value);
+            predicate.number = duration.value_or(0);
+            return duration.has_value();
+        }
+        case Field::Time: {
+            for (const char* format : { "hh:mm:ss.zzz", "hh:mm:ss", "hh:mm" }) {
+                QTime time = QTime::fromString(value, format);
+                if (time.isValid()) {
+                    predicate.timeOfDay = true;
+                    predicate.number = time.msecsSinceStartOfDay();
+                    return true;
+                }
+            }
+
+            QDateTime dateTime = QDateTime::fromString(value, Qt::ISODateWithMs);
+            predicate.number =
+                dateTime.toMSecsSinceEpoch() * nanosecondsPerMillisecond;
+            return dateTime.isValid();
+        }
+        default:
+            predicate.text = value;
+            predicate.utf8 = value.toStdString();
+            predicate.search = QLoguruSubstringSearch(
+                predicate.utf8, predicate.caseSensitivity == Qt::CaseSensitive
+            );
+            return true;
+    }
+}
+
+bool QLoguruQuery::accepts(
+    const predicate_t& predicate, const QLoguruModel& model, std::size_t row
+)
+{
+    const QLoguruStorage& storage = model.storage();
+
+    switch (predicate.field) {
+        case Field::Level:
+            return predicate.levels[ QLoguruLevels::index(storage.level(row)) ];
+        case Field::Logger:
+            return nameMatches(
+                predicate, storage.loggerNames(), storage.loggerId(row)
+            );
+        case Field::File:
+            return nameMatches(
+                predicate, storage.fileNames(), storage.fileId(row)
+            );
+        case Field::Line:
+            return compare(predicate, storage.line(row));
+        case Field::Elapsed:
+            return compare(predicate, storage.elapsed(row));
+        case Field::Time: {
+            std::int64_t time = storage.time(row);
+            if (!predicate.timeOfDay)
+                return compare(predicate, time);
+
+            // Each row gets the offset in effect at its own time, rows from
+            // both sides of a daylight saving change compare alike.
+            return compare(predicate, predicate.localTime.msecsOfDay(time));
+        }
+        case Field::Message:
+            return textMatches(predicate, storage.message(row));
+    }
+
+    return false;
+}
+
+bool QLoguruQuery::compare(const predicate_t& predicate, std::int64_t value)
+{
+    switch (predicate.op) {
+        case Op::Contains:
+        case Op::Equal:
+            return value == predicate.number;
+        case Op::NotEqual:
+            return value != predicate.number;
+        case Op::Less:
+            return value < predicate.number;
+        case Op::LessEqual:
+            return value <= predicate.number;
+        case Op::Greater:
+            return value > predicate.number;
+        case Op::GreaterEqual:
+            return value >= predicate.number;
+    }
+
+    return false;
+}
+
+bool QLoguruQuery::textMatches(
+    const predicate_t& predicate, std::string_view text
+)
+{
+    if (predicate.op == Op::Contains) {
+        if (predicate.search.isCaseSensitive() || predicate.search.isAscii())
+            return predicate.search.contains(text);
+
+        return toQString(text).contains(
+            predicate.text, predicate.caseSensitivity
+        );
+    }
+
+    bool equal = predicate.caseSensitivity == Qt::CaseSensitive
+                     ? text == predicate.utf8
+                     : QString::compare(
+                           toQString(text), predicate.text, Qt::CaseInsensitive
+                       ) == 0;
+    return predicate.op == Op::Equal ? equal : !equal;
+}
+
+bool QLoguruQuery::nameMatches(
+    const predicate_t& predicate,
+    const QLoguruStringTable& names,
+    std::uint32_t id
+)
+{
+    std::vector<std::int8_t>& cache = predicate.names;
+    if (id >= cache.size())
+        cache.resize(names.size(), -1);
+
+    if (cache[ id ] < 0)
+        cache[ id ] = textMatches(predicate, names[ id ]);
+
+    return cache[ id ];
+}
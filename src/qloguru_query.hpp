@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QString>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "qloguru_levels.hpp"
+#include "qloguru_local_time.hpp"
+#include "qloguru_substring_search.hpp"
+
+class QLoguruModel;
+class QLoguruStringTable;
+
+/**
+ * Structured part of a filter text.
+ *
+ * Whitespace separated terms of the form field, operator, value are
+ * predicates on a single column, for example
+ *
+ *     level>=warning logger:worker-3 msg:"timeout" elapsed>12.5s
+ *
+ * Fields are level, logger (or thread), file, msg (or message), line,
+ * elapsed and time. ':' means contains for the text fields and equals for
+ * the others, '=' and '!=' compare the whole value, '<', '<=', '>' and '>='
+ * compare levels by severity and numbers by value. Values may be quoted.
+ * Every other term is free text, searched in all the columns as usual. The
+ * free terms are put back together with single spaces and searched as one
+ * text, as if the predicates had not been typed: "foo level>=error bar"
+ * looks for "foo bar", not for "foo" and "bar" anywhere in the row.
+ *
+ * All the predicates must hold. They are evaluated on the typed columns
+ * and ordered by cost, so comparing a level or a logger id rejects a row
+ * before any text is searched.
+ */
+class QLoguruQuery
+{
+public:
+    QLoguruQuery() = default;
+    QLoguruQuery(const QString& text, bool isCaseSensitive);
+
+    bool isEmpty() const { return _predicates.empty(); }
+    bool isValid() const { return _errorString.isEmpty(); }
+    const QString& errorString() const { return _errorString; }
+
+    /**
+     * @brief The terms which are not predicates, unquoted and joined by
+     * single spaces, the whole text if there are no predicates.
+     */
+    const QString& freeText() const { return _freeText; }
+
+    bool accepts(const QLoguruModel& model, std::size_t row) const;
+
+    /**
+     * @brief Evaluate the name predicates for every name the model knows
+     * about, see QLoguruFilter::prepare().
+     */
+    void prepare(const QLoguruModel& model) const;
+
+    /**
+     * @brief The bytes every accepted message contains, empty if no
+     * predicate requires any.
+     */
+    std::string requiredLiteral() const;
+
+private:
+    enum class Field { Level, Logger, File, Line, Elapsed, Time, Message };
+    enum class Op {
+        Contains,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    struct predicate_t {
+        Field field;
+        Op op;
+        std::int64_t number = 0;
+        // Compare the local time of day rather than the whole timestamp.
+        bool timeOfDay = false;
+        mutable QLoguruLocalTime localTime;
+        std::array<bool, QLoguruLevels::count> levels {};
+        QString text;
+        std::string utf8;
+        QLoguruSubstringSearch search;
+        Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive;
+        mutable std::vector<std::int8_t> names;
+    };
+
+    bool parseTerm(const QString& term, bool isCaseSensitive);
+    bool parseValue(predicate_t& predicate, const QString& value);
+
+    static bool accepts(
+        const predicate_t& predicate, const QLoguruModel& model, std::size_t row
+    );
+    static bool compare(const predicate_t& predicate, std::int64_t value);
+    static bool textMatches(const predicate_t& predicate, std::string_view text);
+    static bool nameMatches(
+        const predicate_t& predicate,
+        const QLoguruStringTable& names,
+        std::uint32_t id
+    );
+
+private:
+    std::vector<predicate_t> _predicates;
+    QString _freeText;
+    QString _errorString;
+};
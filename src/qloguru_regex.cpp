@@ -0,0 +1,313 @@
+#include <algorithm>
+
+#include "qloguru_regex.hpp"
+
+#ifdef QLOGURU_HAS_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
+struct QLoguruRegex::code_t {
+#ifdef QLOGURU_HAS_PCRE2
+    pcre2_code* code = nullptr;
+
+    ~code_t() { pcre2_code_free(code); }
+#endif
+};
+
+namespace
+{
+
+bool isAscii(const std::string& text)
+{
+    return std::all_of(text.begin(), text.end(), [](char c) {
+        return static_cast<unsigned char>(c) < 0x80;
+    });
+}
+
+// Skips a character class starting at the opening bracket, returns the
+// position of the closing one or -1.
+int skipClass(const QString& pattern, int i)
+{
+    ++i;
+    if (i < pattern.size() && pattern[ i ] == '^')
+        ++i;
+    // A leading bracket is part of the class.
+    if (i < pattern.size() && pattern[ i ] == ']')
+        ++i;
+
+    for (; i < pattern.size(); ++i) {
+        if (pattern[ i ] == '\\')
+            ++i;
+        else if (pattern[ i ] == '[' && i + 1 < pattern.size() &&
+                 pattern[ i + 1 ] == ':') {
+            // POSIX classes like [:alpha:]
+            int end = pattern.indexOf(":]", i + 2);
+            if (end < 0)
+                return -1;
+            i = end + 1;
+        } else if (pattern[ i ] == ']')
+            return i;
+    }
+    return -1;
+}
+
+// Skips a group starting at the opening parenthesis, returns the position of
+// the closing one or -1.
+int skipGroup(const QString& pattern, int i)
+{
+    int depth = 0;
+    for (; i < pattern.size(); ++i) {
+        QChar c = pattern[ i ];
+        if (c == '\\')
+            ++i;
+        else if (c == '[') {
+            i = skipClass(pattern, i);
+            if (i < 0)
+                return -1;
+        } else if (c == '(')
+            ++depth;
+        else if (c == ')' && --depth == 0)
+            return i;
+    }
+    return -1;
+}
+
+// Parses the quantifier at i, if any. Returns its length (0 if there is
+// none, -1 if it can't be told) and whether it allows zero repetitions.
+int parseQuantifier(const QString& pattern, int i, bool& optional)
+{
+    if (i >= pattern.size())
+        return 0;
+
+    int length = 0;
+    QChar c = pattern[ i ];
+    if (c == '*' || c == '?') {
+        optional = true;
+        length = 1;
+    } else if (c == '+') {
+        optional = false;
+        length = 1;
+    } else if (c == '{') {
+        int end = pattern.indexOf('}', i);
+        if (end < 0)
+            return -1;
+
+        QString bounds = pattern.mid(i + 1, end - i - 1);
+        bool ok = false;
+        int minimum = bounds.section(',', 0, 0).toInt(&ok);
+        // Anything else, like a literal brace, is left alone.
+        if (!ok)
+            return -1;
+
+        optional = minimum == 0;
+        length = end - i + 1;
+    } else
+        return 0;
+
+    // Lazy and possessive variants.
+    if (i + length < pattern.size() &&
+        (pattern[ i + length ] == '?' || pattern[ i + length ] == '+'))
+        ++length;
+
+    return length;
+}
+
+} // namespace
+
+QLoguruRegex::QLoguruRegex(const QString& pattern, bool isCaseSensitive)
+    : _regex(
+          pattern,
+          isCaseSensitive ? QRegularExpression::NoPatternOption
+                          : QRegularExpression::CaseInsensitiveOption
+      )
+{
+    if (!_regex.isValid())
+        return;
+
+    _literal = requiredLiteral(pattern);
+    // Ignoring the case of anything but ASCII is up to the regex.
+    if (!isCaseSensitive && !isAscii(_literal))
+        _literal.clear();
+    _prefilter = QLoguruSubstringSearch(_literal, isCaseSensitive);
+
+#ifdef QLOGURU_HAS_PCRE2
+    QByteArray utf8 = pattern.toUtf8();
+    std::uint32_t options = PCRE2_UTF;
+#ifdef PCRE2_MATCH_INVALID_UTF
+    // Log messages are not guaranteed to be valid UTF-8.
+    options |= PCRE2_MATCH_INVALID_UTF;
+#endif
+    if (!isCaseSensitive)
+        options |= PCRE2_CASELESS;
+
+    int error = 0;
+    PCRE2_SIZE errorOffset = 0;
+    pcre2_code* code = pcre2_compile(
+        reinterpret_cast<PCRE2_SPTR>(utf8.constData()),
+        utf8.size(),
+        options,
+        &error,
+        &errorOffset,
+        nullptr
+    );
+    if (!code)
+        return;
+
+    // Without JIT support pcre2_match falls back to the interpreter.
+    pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+
+    _code = std::make_shared<code_t>();
+    _code->code = code;
+    createMatchData();
+#endif
+}
+
+QLoguruRegex::QLoguruRegex(const QLoguruRegex& other)
+    : _regex(other._regex)
+    , _literal(other._literal)
+    , _prefilter(other._prefilter)
+    , _code(other._code)
+{
+    createMatchData();
+}
+
+QLoguruRegex& QLoguruRegex::operator=(const QLoguruRegex& other)
+{
+    if (this == &other)
+        return *this;
+
+    _regex = other._regex;
+    _literal = other._literal;
+    _prefilter = other._prefilter;
+    _code = other._code;
+    createMatchData();
+    return *this;
+}
+
+QLoguruRegex::~QLoguruRegex()
+{
+#ifdef QLOGURU_HAS_PCRE2
+    pcre2_match_data_free(static_cast<pcre2_match_data*>(_matchData));
+#endif
+}
+
+void QLoguruRegex::createMatchData()
+{
+#ifdef QLOGURU_HAS_PCRE2
+    pcre2_match_data_free(static_cast<pcre2_match_data*>(_matchData));
+    _matchData = _code ? pcre2_match_data_create_from_pattern(_code->code, nullptr)
+                       : nullptr;
+#endif
+}
+
+bool QLoguruRegex::matches(std::string_view text) const
+{
+    if (!_literal.empty() && !_prefilter.contains(text))
+        return false;
+
+#ifdef QLOGURU_HAS_PCRE2
+    if (_code) {
+        int result = pcre2_match(
+            _code->code,
+            reinterpret_cast<PCRE2_SPTR>(text.data()),
+            text.size(),
+            0,
+            0,
+            static_cast<pcre2_match_data*>(_matchData),
+            nullptr
+        );
+        return result >= 0;
+    }
+#endif
+
+    return matches(
+        QString::fromUtf8(text.data(), static_cast<int>(text.size()))
+    );
+}
+
+bool QLoguruRegex::matches(const QString& text) const
+{
+    return _regex.match(text).hasMatch();
+}
+
+std::string QLoguruRegex::requiredLiteral(const QString& pattern)
+{
+    QString best;
+    QString run;
+    auto flush = [ & ]() {
+        if (run.size() > best.size())
+            best = run;
+        run.clear();
+    };
+
+    for (int i = 0; i < pattern.size();) {
+        QChar c = pattern[ i ];
+        QString atom; // empty when the atom isn't a literal
+        int next = i + 1;
+
+        if (c == '|')
+            return {};
+
+        if (c == '\\') {
+            if (i + 1 >= pattern.size())
+                return {};
+
+            QChar escaped = pattern[ i + 1 ];
+            next = i + 2;
+            if (!escaped.isLetterOrNumber())
+                atom = escaped;
+            else if (QString("QEkgcPpxoN").contains(escaped)) {
+                // Quoting and escapes with arguments, not worth the trouble.
+                return {};
+            }
+        } else if (c == '[') {
+            int end = skipClass(pattern, i);
+            if (end < 0)
+                return {};
+            next = end + 1;
+        } else if (c == '(') {
+            // Inline options and lookarounds change the meaning of the rest.
+            if (i + 1 < pattern.size() && pattern[ i + 1 ] == '?' &&
+                (i + 2 >= pattern.size() || pattern[ i + 2 ] != ':'))
+                return {};
+
+            int end = skipGroup(pattern, i);
+            if (end < 0)
+                return {};
+            // An alternation inside the group is fine, the group isn't used.
+            next = end + 1;
+        } else if (c == ')' || c == '{' || c == '}' || c == '*' || c == '+' ||
+                   c == '?') {
+            return {};
+        } else if (c == '.' || c == '^' || c == '$') {
+            // Not a literal, or a zero width assertion; either way the run
+            // ends here.
+        } else if (c.isHighSurrogate() && i + 1 < pattern.size() &&
+                   pattern[ i + 1 ].isLowSurrogate()) {
+            atom = pattern.mid(i, 2);
+            next = i + 2;
+        } else
+            atom = c;
+
+        bool optional = false;
+        int quantifier = parseQuantifier(pattern, next, optional);
+        if (quantifier < 0)
+            return {};
+
+        if (atom.isEmpty() || (quantifier > 0 && optional))
+            flush();
+        else {
+            run += atom;
+            // A repeated character is required once, but the run can't go on
+            // past the repetition.
+            if (quantifier > 0)
+                flush();
+        }
+
+        i = next + quantifier;
+    }
+    flush();
+
+    return best.toStdString();
+}
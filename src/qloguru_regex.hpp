@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "qloguru_substring_search.hpp"
+
+/**
+ * Regular expression matched directly against UTF-8 bytes.
+ *
+ * A literal every match must contain is extracted from the pattern and
+ * searched first with QLoguruSubstringSearch, the expression itself only runs
+ * on the texts containing it. When PCRE2 is available
+ * (QLOGURU_HAS_PCRE2) the expression is JIT compiled and matched on the bytes
+ * as they are, otherwise the candidates are converted for QRegularExpression.
+ *
+ * Copies share the compiled pattern but not the match data, so every thread
+ * needs its own copy.
+ */
+class QLoguruRegex
+{
+public:
+    QLoguruRegex() = default;
+    QLoguruRegex(const QString& pattern, bool isCaseSensitive);
+    QLoguruRegex(const QLoguruRegex& other);
+    QLoguruRegex& operator=(const QLoguruRegex& other);
+    ~QLoguruRegex();
+
+    bool isValid() const { return _regex.isValid(); }
+    QString errorString() const { return _regex.errorString(); }
+
+    bool matches(std::string_view text) const;
+    bool matches(const QString& text) const;
+
+    /**
+     * @brief The literal every match contains, empty if there is none.
+     */
+    const std::string& requiredLiteral() const { return _literal; }
+
+    /**
+     * @brief Find the longest literal every match of the pattern contains.
+     *
+     * The analysis is conservative: alternations, inline options and
+     * anything it doesn't understand give up and return an empty string.
+     */
+    static std::string requiredLiteral(const QString& pattern);
+
+private:
+    struct code_t;
+
+    void createMatchData();
+
+private:
+    QRegularExpression _regex;
+    std::string _literal;
+    QLoguruSubstringSearch _prefilter;
+    std::shared_ptr<code_t> _code;
+    void* _matchData = nullptr;
+};
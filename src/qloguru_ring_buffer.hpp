@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+#include "qloguru/qloguru.hpp"
+
+/**
+ * @brief Bounded lock-free multi-producer/single-consumer ring buffer.
+ *
+ * Based on Dmitry Vyukov's bounded queue: every cell carries a sequence
+ * number that tells producers and the consumer whether the cell is free or
+ * holds a value for the current lap. The capacity is rounded up to the next
+ * power of two.
+ *
+ * The queue is safe for several consumers as well, which is what allows a
+ * producer to evict the oldest element under the drop-oldest policy.
+ */
+template <typename T>
+class QLoguruRingBuffer
+{
+public:
+    explicit QLoguruRingBuffer(
+        std::size_t capacity,
+        OverflowPolicy policy = OverflowPolicy::OverflowPolicyDropOldest
+    )
+        : _capacity(roundUp(capacity))
+        , _mask(_capacity - 1)
+        , _cells(new cell_t[ _capacity ])
+        , _policy(policy)
+    {
+        for (std::size_t i = 0; i < _capacity; ++i)
+            _cells[ i ].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    QLoguruRingBuffer(const QLoguruRingBuffer&) = delete;
+    QLoguruRingBuffer& operator=(const QLoguruRingBuffer&) = delete;
+
+    /**
+     * @brief Push a value applying the current overflow policy.
+     *
+     * @return true if the value was stored, false if it was dropped
+     */
+    bool push(T&& value)
+    {
+        switch (_policy.load(std::memory_order_relaxed)) {
+            case OverflowPolicy::OverflowPolicyDropNewest: {
+                if (tryPush(std::move(value)))
+                    return true;
+
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            case OverflowPolicy::OverflowPolicyDropOldest: {
+                while (!tryPush(std::move(value))) {
+                    T discarded;
+                    if (tryPop(discarded))
+                        _dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+
+            case OverflowPolicy::OverflowPolicyBlock: {
+                // The loguru callbacks run under loguru's own mutex, so the
+                // wait is bounded to never starve the consumer forever.
+                auto deadline = std::chrono::steady_clock::now() + _blockTimeout;
+                while (!tryPush(std::move(value))) {
+                    if (std::chrono::steady_clock::now() > deadline) {
+                        _dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    std::this_thread::yield();
+                }
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool tryPush(T&& value)
+    {
+        std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        cell_t* cell;
+        for (;;) {
+            cell = &_cells[ pos & _mask ];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    ))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        updateHighWaterMark(pos + 1);
+        return true;
+    }
+
+    bool tryPop(T& value)
+    {
+        std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+        cell_t* cell;
+        for (;;) {
+            cell = &_cells[ pos & _mask ];
+            std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (_dequeuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed
+                    ))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of buffered values.
+     */
+    std::size_t size() const
+    {
+        std::size_t enqueued = _enqueuePos.load(std::memory_order_relaxed);
+        std::size_t dequeued = _dequeuePos.load(std::memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    std::size_t capacity() const { return _capacity; }
+
+    void setPolicy(OverflowPolicy policy)
+    {
+        _policy.store(policy, std::memory_order_relaxed);
+    }
+
+    OverflowPolicy policy() const
+    {
+        return _policy.load(std::memory_order_relaxed);
+    }
+
+    void setBlockTimeout(std::chrono::milliseconds timeout)
+    {
+        _blockTimeout = timeout;
+    }
+
+    std::size_t droppedCount() const
+    {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    std::size_t highWaterMark() const
+    {
+        return _highWaterMark.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct cell_t {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    static std::size_t roundUp(std::size_t capacity)
+    {
+        std::size_t result = 2;
+        while (result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    void updateHighWaterMark(std::size_t enqueued)
+    {
+        std::size_t dequeued = _dequeuePos.load(std::memory_order_relaxed);
+        std::size_t used = enqueued > dequeued ? enqueued - dequeued : 0;
+        std::size_t current = _highWaterMark.load(std::memory_order_relaxed);
+        while (used > current &&
+               !_highWaterMark.compare_exchange_weak(
+                   current, used, std::memory_order_relaxed
+               )) { }
+    }
+
+private:
+    static constexpr std::size_t cacheLineSize = 64;
+
+    const std::size_t _capacity;
+    const std::size_t _mask;
+    std::unique_ptr<cell_t[]> _cells;
+    std::atomic<OverflowPolicy> _policy;
+    std::chrono::milliseconds _blockTimeout { 100 };
+    alignas(cacheLineSize) std::atomic<std::size_t> _enqueuePos { 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> _dequeuePos { 0 };
+    alignas(cacheLineSize) std::atomic<std::size_t> _dropped { 0 };
+    std::atomic<std::size_t> _highWaterMark { 0 };
+};
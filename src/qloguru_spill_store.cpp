@@ -0,0 +1,175 @@
+#include <QDir>
+#include <QFile>
+#include <QTemporaryFile>
+#include <algorithm>
+
+#include "qloguru_spill_store.hpp"
+
+namespace
+{
+
+template<typename T>
+bool writeColumn(QTemporaryFile& file, const T* data, std::size_t count)
+{
+    auto bytes = static_cast<qint64>(count * sizeof(T));
+    return file.write(reinterpret_cast<const char*>(data), bytes) == bytes;
+}
+
+} // namespace
+
+QLoguruSpillStore::QLoguruSpillStore(
+    QString directory, std::size_t segmentRows
+)
+    : _directory(std::move(directory))
+    , _segmentRows(segmentRows)
+{
+}
+
+QLoguruSpillStore::~QLoguruSpillStore() = default;
+
+std::unique_ptr<QTemporaryFile> QLoguruSpillStore::createFile() const
+{
+    auto file = std::make_unique<QTemporaryFile>(
+        QDir(_directory).filePath("qloguru-XXXXXX.segment")
+    );
+    if (!file->open())
+        return nullptr;
+
+    return file;
+}
+
+bool QLoguruSpillStore::write(QTemporaryFile& file, const columns_t& columns)
+{
+    const std::size_t rows = columns.time.size();
+
+    // The columns with the largest values come first, every one of them is
+    // then aligned without padding.
+    return writeColumn(file, columns.time.data(), rows) &&
+           writeColumn(file, columns.elapsed.data(), rows) &&
+           writeColumn(file, columns.messageOffset.data(), rows + 1) &&
+           writeColumn(file, columns.line.data(), rows) &&
+           writeColumn(file, columns.logger.data(), rows) &&
+           writeColumn(file, columns.file.data(), rows) &&
+           writeColumn(file, columns.level.data(), rows) &&
+           writeColumn(
+               file, columns.messages.data(), columns.messages.size()
+           ) &&
+           file.flush();
+}
+
+bool QLoguruSpillStore::append(std::unique_ptr<QTemporaryFile> file)
+{
+    const std::size_t rows = _segmentRows;
+
+    // QTemporaryFile keeps its descriptor open until it's destroyed, the
+    // file is reopened to be closed right after mapping it.
+    file->setAutoRemove(false);
+    std::unique_ptr<QFile, remove_file_t> handle(new QFile(file->fileName()));
+    file.reset();
+
+    uchar* base = nullptr;
+    if (handle->open(QIODevice::ReadOnly))
+        base = handle->map(0, handle->size());
+    if (!base)
+        return false;
+
+    // The mapping stays valid until the QFile is destroyed.
+    segment_t segment;
+    segment.bytes = static_cast<std::size_t>(handle->size());
+    handle->close();
+    segment.handle = std::move(handle);
+
+    const uchar* cursor = base;
+    auto take = [ & ]<typename T>(const T*& column, std::size_t count) {
+        column = reinterpret_cast<const T*>(cursor);
+        cursor += count * sizeof(T);
+    };
+    take(segment.time, rows);
+    take(segment.elapsed, rows);
+    take(segment.messageOffset, rows + 1);
+    take(segment.line, rows);
+    take(segment.logger, rows);
+    take(segment.file, rows);
+    take(segment.level, rows);
+    segment.messages = reinterpret_cast<const char*>(cursor);
+
+    _segments.push_back(std::move(segment));
+    _size += rows;
+    return true;
+}
+
+void QLoguruSpillStore::popFront(std::size_t count)
+{
+    count = std::min(count, _size);
+    _size -= count;
+    _head += count;
+
+    // Unmapping happens as the file is destroyed.
+    while (_head >= _segmentRows && !_segments.empty()) {
+        _segments.pop_front();
+        _head -= _segmentRows;
+    }
+    if (_size == 0)
+        clear();
+}
+
+void QLoguruSpillStore::clear()
+{
+    _segments.clear();
+    _head = 0;
+    _size = 0;
+}
+
+void QLoguruSpillStore::remove_file_t::operator()(QFile* file) const
+{
+    // Unmapped first, mapped files can't be removed on every system.
+    QString path = file->fileName();
+    delete file;
+    QFile::remove(path);
+}
+
+std::int64_t QLoguruSpillStore::time(std::size_t row) const
+{
+    return locate(row).time[ row ];
+}
+
+std::int64_t QLoguruSpillStore::elapsed(std::size_t row) const
+{
+    return locate(row).elapsed[ row ];
+}
+
+int QLoguruSpillStore::level(std::size_t row) const
+{
+    return locate(row).level[ row ];
+}
+
+unsigned QLoguruSpillStore::line(std::size_t row) const
+{
+    return locate(row).line[ row ];
+}
+
+std::uint32_t QLoguruSpillStore::loggerId(std::size_t row) const
+{
+    return locate(row).logger[ row ];
+}
+
+std::uint32_t QLoguruSpillStore::fileId(std::size_t row) const
+{
+    return locate(row).file[ row ];
+}
+
+std::string_view QLoguruSpillStore::message(std::size_t row) const
+{
+    const segment_t& segment = locate(row);
+    std::uint64_t begin = segment.messageOffset[ row ];
+    std::uint64_t end = segment.messageOffset[ row + 1 ];
+    return { segment.messages + begin, static_cast<std::size_t>(end - begin) };
+}
+
+std::size_t QLoguruSpillStore::diskUsage() const
+{
+    std::size_t result = 0;
+    for (const segment_t& segment : _segments)
+        result += segment.bytes;
+    return result;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class QFile;
+class QTemporaryFile;
+
+/**
+ * Rows moved out of memory into memory-mapped files.
+ *
+ * The rows are written in segments of a fixed number of rows, one file per
+ * segment, laid out column by column so a row is read straight from the
+ * mapping. The pages are backed by the files, the system can drop them
+ * whenever memory gets short and reads them back on access. The files are
+ * closed once mapped, the number of segments isn't bounded by the limit of
+ * open files. Segments are only ever appended at the back and evicted from
+ * the front; the files are removed along with their segment.
+ */
+class QLoguruSpillStore
+{
+public:
+    static constexpr std::size_t defaultSegmentRows = 65536;
+
+    // Columns of the rows of a segment, as written.
+    struct columns_t {
+        std::vector<std::int64_t> time;
+        std::vector<std::int64_t> elapsed;
+        std::vector<std::uint32_t> line;
+        std::vector<std::uint32_t> logger;
+        std::vector<std::uint32_t> file;
+        std::vector<std::int8_t> level;
+        // Message i is between offsets i and i + 1 of the packed messages.
+        std::vector<std::uint64_t> messageOffset;
+        std::string messages;
+    };
+
+public:
+    explicit QLoguruSpillStore(
+        QString directory, std::size_t segmentRows = defaultSegmentRows
+    );
+    ~QLoguruSpillStore();
+    QLoguruSpillStore(const QLoguruSpillStore&) = delete;
+    QLoguruSpillStore& operator=(const QLoguruSpillStore&) = delete;
+
+    /**
+     * @brief Set the directory of the segments written from now on.
+     */
+    void setDirectory(QString directory) { _directory = std::move(directory); }
+    const QString& directory() const { return _directory; }
+
+    std::size_t segmentRows() const { return _segmentRows; }
+
+    /**
+     * @brief Create the file of a new segment in the directory.
+     *
+     * @return nullptr if the file couldn't be created
+     */
+    std::unique_ptr<QTemporaryFile> createFile() const;
+
+    /**
+     * @brief Write the columns of a segment to its file.
+     *
+     * Doesn't touch the store, it's safe to call from any thread.
+     */
+    static bool write(QTemporaryFile& file, const columns_t& columns);
+
+    /**
+     * @brief Append a segment of segmentRows rows written to its file.
+     *
+     * The file is closed and only its mapping kept.
+     *
+     * @return false if the file couldn't be mapped, the file is removed and
+     * the store is left unchanged
+     */
+    bool append(std::unique_ptr<QTemporaryFile> file);
+    void popFront(std::size_t count);
+    void clear();
+
+    std::size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    std::int64_t time(std::size_t row) const;
+    std::int64_t elapsed(std::size_t row) const;
+    int level(std::size_t row) const;
+    unsigned line(std::size_t row) const;
+    std::uint32_t loggerId(std::size_t row) const;
+    std::uint32_t fileId(std::size_t row) const;
+    std::string_view message(std::size_t row) const;
+
+    /**
+     * @brief Number of bytes written to the files.
+     */
+    std::size_t diskUsage() const;
+
+private:
+    // Removes the file of a segment once it's unmapped.
+    struct remove_file_t {
+        void operator()(QFile* file) const;
+    };
+
+    // Columns pointing into the mapping of the file.
+    struct segment_t {
+        std::unique_ptr<QFile, remove_file_t> handle;
+        std::size_t bytes;
+        const std::int64_t* time;
+        const std::int64_t* elapsed;
+        const std::uint64_t* messageOffset;
+        const std::uint32_t* line;
+        const std::uint32_t* logger;
+        const std::uint32_t* file;
+        const std::int8_t* level;
+        const char* messages;
+    };
+
+    const segment_t& locate(std::size_t& row) const
+    {
+        row += _head;
+        const segment_t& segment = _segments[ row / _segmentRows ];
+        row %= _segmentRows;
+        return segment;
+    }
+
+private:
+    QString _directory;
+    std::size_t _segmentRows;
+    std::deque<segment_t> _segments;
+    // Rows of the first segment already evicted.
+    std::size_t _head = 0;
+    std::size_t _size = 0;
+};
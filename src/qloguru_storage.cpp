@@ -0,0 +1,311 @@
+#include <QTemporaryFile>
+#include <QThreadPool>
+#include <algorithm>
+#include <chrono>
+
+#include "qloguru_storage.hpp"
+
+// Segment being written by a worker, along with the copy of its rows.
+struct QLoguruStorage::pending_spill_t {
+    std::uint64_t firstId;
+    std::unique_ptr<QTemporaryFile> file;
+    columns_t columns;
+    std::promise<bool> promise;
+    std::future<bool> written = promise.get_future();
+};
+
+QLoguruStorage::~QLoguruStorage()
+{
+    if (_pendingSpill)
+        _pendingSpill->written.wait();
+}
+
+void QLoguruStorage::append(const entry_t& entry)
+{
+    _time.push_back(entry.time);
+    _elapsed.push_back(entry.elapsed);
+    _level.push_back(static_cast<std::int8_t>(
+        std::clamp(entry.level, INT8_MIN, static_cast<int>(INT8_MAX))
+    ));
+    _line.push_back(entry.line);
+    _logger.push_back(_loggerNames.intern(entry.loggerName));
+    _file.push_back(_fileNames.intern(entry.file));
+    appendMessage(entry.message);
+}
+
+void QLoguruStorage::append(const columns_t& columns)
+{
+    const std::size_t rows = columns.time.size();
+
+    _time.insert(_time.end(), columns.time.begin(), columns.time.end());
+    _elapsed.insert(
+        _elapsed.end(), columns.elapsed.begin(), columns.elapsed.end()
+    );
+    _level.insert(_level.end(), columns.level.begin(), columns.level.end());
+    _line.insert(_line.end(), columns.line.begin(), columns.line.end());
+    _logger.insert(
+        _logger.end(), columns.logger.begin(), columns.logger.end()
+    );
+    _file.insert(_file.end(), columns.file.begin(), columns.file.end());
+    std::string_view messages = columns.messages;
+    for (std::size_t row = 0; row < rows; ++row) {
+        std::uint64_t begin = columns.messageOffset[ row ];
+        std::uint64_t end = columns.messageOffset[ row + 1 ];
+        appendMessage(messages.substr(begin, end - begin));
+    }
+}
+
+QLoguruStorage::columns_t QLoguruStorage::columns(
+    std::size_t first, std::size_t count
+) const
+{
+    columns_t result;
+    result.time.reserve(count);
+    result.elapsed.reserve(count);
+    result.line.reserve(count);
+    result.logger.reserve(count);
+    result.file.reserve(count);
+    result.level.reserve(count);
+    result.messageOffset.reserve(count + 1);
+    result.messageOffset.push_back(0);
+
+    for (std::size_t row = first; row < first + count; ++row) {
+        result.time.push_back(time(row));
+        result.elapsed.push_back(elapsed(row));
+        result.line.push_back(line(row));
+        result.logger.push_back(loggerId(row));
+        result.file.push_back(fileId(row));
+        result.level.push_back(static_cast<std::int8_t>(level(row)));
+        result.messages.append(message(row));
+        result.messageOffset.push_back(result.messages.size());
+    }
+
+    return result;
+}
+
+void QLoguruStorage::spill()
+{
+    if (!_spill)
+        return;
+
+    // Whole segments are spilled at once, the rows in memory go between
+    // memoryRows and memoryRows plus a segment. One segment is written at a
+    // time, the next one only waits for it once the rows in memory grew by
+    // another whole segment meanwhile, after a large batch for instance.
+    const std::size_t rows = _spill->segmentRows();
+    for (;;) {
+        if (_pendingSpill) {
+            bool isBehind = _time.size() >= _memoryRows + 2 * rows;
+            auto status =
+                _pendingSpill->written.wait_for(std::chrono::seconds(0));
+            if (!isBehind && status != std::future_status::ready)
+                return;
+
+            finishSpill();
+        }
+
+        if (!_isSpilling || _time.size() < _memoryRows + rows ||
+            !startSpill())
+            return;
+    }
+}
+
+bool QLoguruStorage::startSpill()
+{
+    // Without room on disk the rows simply stay in memory.
+    std::unique_ptr<QTemporaryFile> file = _spill->createFile();
+    if (!file) {
+        _isSpilling = false;
+        return false;
+    }
+
+    // Only the GUI thread modifies the store, it reads it without the lock.
+    const std::size_t rows = _spill->segmentRows();
+    auto pending = std::make_shared<pending_spill_t>();
+    pending->firstId = _firstId + spilledRows();
+    pending->file = std::move(file);
+    pending->columns = columns(spilledRows(), rows);
+    _pendingSpill = pending;
+
+    QThreadPool::globalInstance()->start([ pending ]() {
+        bool isWritten =
+            QLoguruSpillStore::write(*pending->file, pending->columns);
+        pending->columns = {};
+        pending->promise.set_value(isWritten);
+    });
+    return true;
+}
+
+void QLoguruStorage::waitForSpill()
+{
+    if (_pendingSpill)
+        finishSpill();
+}
+
+void QLoguruStorage::finishSpill()
+{
+    std::shared_ptr<pending_spill_t> pending = std::move(_pendingSpill);
+    bool isWritten = pending->written.get();
+    if (!isWritten) {
+        _isSpilling = false;
+        return;
+    }
+
+    // Evicting takes the spilled rows first, the rows evicted while the
+    // segment was written are at its front and nothing was spilled before.
+    const std::size_t rows = _spill->segmentRows();
+    std::uint64_t firstId = _firstId + spilledRows();
+    std::size_t evicted = static_cast<std::size_t>(
+        std::max(firstId, pending->firstId) - pending->firstId
+    );
+    if (evicted >= rows)
+        return;
+
+    std::unique_lock lock(_mutex);
+    if (!_spill->append(std::move(pending->file))) {
+        _isSpilling = false;
+        return;
+    }
+
+    _spill->popFront(evicted);
+    popMemory(rows - evicted);
+}
+
+void QLoguruStorage::appendMessage(std::string_view message)
+{
+    if (_chunks.empty() ||
+        _chunks.back().capacity - _chunks.back().used < message.size()) {
+        // Messages never straddle chunks, a message bigger than the usual
+        // chunk gets a chunk of its own.
+        auto capacity = static_cast<std::uint32_t>(
+            std::max<std::size_t>(chunkSize, message.size())
+        );
+        _chunks.push_back({ std::make_unique<char[]>(capacity), capacity, 0 });
+    }
+
+    chunk_t& chunk = _chunks.back();
+    std::copy(message.begin(), message.end(), chunk.data.get() + chunk.used);
+
+    _messageChunk.push_back(
+        _firstChunk + static_cast<std::uint32_t>(_chunks.size() - 1)
+    );
+    _messageOffset.push_back(chunk.used);
+    _messageLength.push_back(static_cast<std::uint32_t>(message.size()));
+    chunk.used += static_cast<std::uint32_t>(message.size());
+}
+
+void QLoguruStorage::popFront(std::size_t count)
+{
+    count = std::min(count, size());
+    if (count == size()) {
+        clear();
+        return;
+    }
+
+    _firstId += count;
+
+    std::size_t spilled = std::min(count, spilledRows());
+    if (spilled > 0)
+        _spill->popFront(spilled);
+    popMemory(count - spilled);
+}
+
+void QLoguruStorage::popMemory(std::size_t count)
+{
+    if (count == 0)
+        return;
+
+    auto erase = [ count ](auto& column) {
+        column.erase(column.begin(), column.begin() + count);
+    };
+
+    erase(_time);
+    erase(_elapsed);
+    erase(_level);
+    erase(_line);
+    erase(_logger);
+    erase(_file);
+    erase(_messageChunk);
+    erase(_messageOffset);
+    erase(_messageLength);
+
+    // Release the chunks the remaining rows don't refer to anymore.
+    std::uint32_t firstChunk =
+        _messageChunk.empty()
+            ? _firstChunk + static_cast<std::uint32_t>(_chunks.size())
+            : _messageChunk.front();
+    while (_firstChunk < firstChunk) {
+        _chunks.pop_front();
+        ++_firstChunk;
+    }
+}
+
+void QLoguruStorage::clear()
+{
+    _firstId += size();
+    _time.clear();
+    _elapsed.clear();
+    _level.clear();
+    _line.clear();
+    _logger.clear();
+    _file.clear();
+    _messageChunk.clear();
+    _messageOffset.clear();
+    _messageLength.clear();
+    _firstChunk += static_cast<std::uint32_t>(_chunks.size());
+    _chunks.clear();
+    if (_spill)
+        _spill->clear();
+}
+
+std::string_view QLoguruStorage::message(std::size_t row) const
+{
+    if (isSpilled(row))
+        return _spill->message(row);
+
+    row = hot(row);
+    const chunk_t& chunk = _chunks[ _messageChunk[ row ] - _firstChunk ];
+    return { chunk.data.get() + _messageOffset[ row ], _messageLength[ row ] };
+}
+
+std::string_view QLoguruStorage::loggerName(std::uint32_t id) const
+{
+    return _loggerNames[ id ];
+}
+
+std::string_view QLoguruStorage::fileName(std::uint32_t id) const
+{
+    return _fileNames[ id ];
+}
+
+std::size_t QLoguruStorage::memoryUsage() const
+{
+    constexpr std::size_t bytesPerRow =
+        sizeof(std::int64_t) * 2 + sizeof(std::int8_t) +
+        sizeof(std::uint32_t) * 6;
+
+    std::size_t result = _time.size() * bytesPerRow;
+    for (const chunk_t& chunk : _chunks)
+        result += chunk.capacity;
+
+    return result + _loggerNames.memoryUsage() + _fileNames.memoryUsage();
+}
+
+void QLoguruStorage::setSpillDirectory(const QString& directory)
+{
+    _isSpilling = !directory.isEmpty();
+    if (!_isSpilling)
+        return;
+
+    if (_spill)
+        _spill->setDirectory(directory);
+    else
+        _spill = std::make_unique<QLoguruSpillStore>(directory, _segmentRows);
+}
+
+QString QLoguruStorage::spillDirectory() const
+{
+    return _isSpilling ? _spill->directory() : QString();
+}
+
+void QLoguruStorage::setMemoryRows(std::size_t rows) { _memoryRows = rows; }
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <QString>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include "qloguru_spill_store.hpp"
+#include "qloguru_string_table.hpp"
+
+/**
+ * Column oriented store of the log entries.
+ *
+ * Every field lives in its own column, the thread and file names are
+ * interned and the message bytes are packed into large chunks, so a row costs
+ * a few dozen bytes on top of its message. Rows are only ever appended at the
+ * back and evicted from the front; evicting releases whole message chunks
+ * once none of the remaining rows refer to them.
+ *
+ * With a spill directory, only the most recent rows are kept in memory, the
+ * older ones are moved segment by segment to a QLoguruSpillStore. Segments
+ * are written in the background, their rows stay in memory until then. Rows
+ * are read the same way whichever tier they are in.
+ */
+class QLoguruStorage
+{
+public:
+    struct entry_t {
+        std::int64_t time;    // nanoseconds since epoch
+        std::int64_t elapsed; // nanoseconds since the logging started
+        int level;
+        std::string message;
+        std::string loggerName;
+        std::string file;
+        unsigned line;
+    };
+
+    using columns_t = QLoguruSpillStore::columns_t;
+
+    static constexpr std::size_t chunkSize = 1 << 20;
+    static constexpr std::size_t defaultMemoryRows = 1 << 20;
+
+public:
+    QLoguruStorage() = default;
+    ~QLoguruStorage();
+    QLoguruStorage(const QLoguruStorage&) = delete;
+    QLoguruStorage& operator=(const QLoguruStorage&) = delete;
+
+    void append(const entry_t& entry);
+
+    /**
+     * @brief Append rows given column by column.
+     *
+     * The logger and file ids have to be ids of this store's tables.
+     */
+    void append(const columns_t& columns);
+    void popFront(std::size_t count);
+    void clear();
+
+    std::size_t size() const { return spilledRows() + _time.size(); }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Absolute id of the first row.
+     *
+     * Every appended row gets the next id and keeps it until it's evicted, so
+     * ids can be used to refer to rows across evictions.
+     */
+    std::uint64_t firstId() const { return _firstId; }
+
+    std::int64_t time(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->time(row) : _time[ hot(row) ];
+    }
+    std::int64_t elapsed(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->elapsed(row) : _elapsed[ hot(row) ];
+    }
+    int level(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->level(row) : _level[ hot(row) ];
+    }
+    unsigned line(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->line(row) : _line[ hot(row) ];
+    }
+    std::uint32_t loggerId(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->loggerId(row) : _logger[ hot(row) ];
+    }
+    std::uint32_t fileId(std::size_t row) const
+    {
+        return isSpilled(row) ? _spill->fileId(row) : _file[ hot(row) ];
+    }
+    std::string_view message(std::size_t row) const;
+
+    /**
+     * @brief Copy count rows from the given one on into columns.
+     */
+    columns_t columns(std::size_t first, std::size_t count) const;
+
+    std::string_view loggerName(std::uint32_t id) const;
+    std::string_view fileName(std::uint32_t id) const;
+
+    QLoguruStringTable& loggerNames() { return _loggerNames; }
+    const QLoguruStringTable& loggerNames() const { return _loggerNames; }
+    QLoguruStringTable& fileNames() { return _fileNames; }
+    const QLoguruStringTable& fileNames() const { return _fileNames; }
+
+    /**
+     * @brief Mutex guarding the store against concurrent readers.
+     *
+     * The store is only modified by the GUI thread, which doesn't need to
+     * lock for reading. Background readers take it shared, the GUI thread
+     * takes it exclusively while appending or evicting rows.
+     */
+    std::shared_mutex& mutex() const { return _mutex; }
+
+    /**
+     * @brief Set the directory the older rows are spilled to.
+     *
+     * An empty directory stops spilling, the rows already spilled stay on
+     * disk until they're evicted.
+     */
+    void setSpillDirectory(const QString& directory);
+    QString spillDirectory() const;
+
+    /**
+     * @brief Set the number of most recent rows kept in memory while
+     * spilling.
+     */
+    void setMemoryRows(std::size_t rows);
+    std::size_t memoryRows() const { return _memoryRows; }
+
+    /**
+     * @brief Set the number of rows spilled at once, to a file of their own.
+     *
+     * Only taken into account before the spill directory is first set.
+     */
+    void setSegmentRows(std::size_t rows) { _segmentRows = rows; }
+
+    /**
+     * @brief Spill the oldest rows in memory once there are too many.
+     *
+     * The rows are copied and written to a segment in the background, a
+     * later call swaps the written segment in for them. A call waits for
+     * the segment being written when a whole segment more is due, so a
+     * large batch leaves at most two segments over the limit. The mutex is
+     * only taken, exclusively, for the swap: the GUI thread calls this
+     * without holding it.
+     */
+    void spill();
+
+    /**
+     * @brief Wait for the segment being written, if any, and swap it in.
+     *
+     * Same locking as spill().
+     */
+    void waitForSpill();
+
+    std::size_t spilledRows() const { return _spill ? _spill->size() : 0; }
+
+    /**
+     * @brief Approximate number of bytes held by the store in memory.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * @brief Number of bytes of the spilled rows.
+     */
+    std::size_t diskUsage() const { return _spill ? _spill->diskUsage() : 0; }
+
+private:
+    struct chunk_t {
+        std::unique_ptr<char[]> data;
+        std::uint32_t capacity;
+        std::uint32_t used;
+    };
+
+    struct pending_spill_t;
+
+    void appendMessage(std::string_view message);
+    bool startSpill();
+    void finishSpill();
+    void popMemory(std::size_t count);
+
+    bool isSpilled(std::size_t row) const
+    {
+        return _spill && row < _spill->size();
+    }
+    std::size_t hot(std::size_t row) const { return row - spilledRows(); }
+
+private:
+    std::deque<std::int64_t> _time;
+    std::deque<std::int64_t> _elapsed;
+    std::deque<std::int8_t> _level;
+    std::deque<std::uint32_t> _line;
+    std::deque<std::uint32_t> _logger;
+    std::deque<std::uint32_t> _file;
+
+    // Messages are addressed by the absolute number of the chunk they are in,
+    // so evicting chunks doesn't require touching the remaining rows.
+    std::deque<std::uint32_t> _messageChunk;
+    std::deque<std::uint32_t> _messageOffset;
+    std::deque<std::uint32_t> _messageLength;
+    std::deque<chunk_t> _chunks;
+    std::uint32_t _firstChunk = 0;
+
+    QLoguruStringTable _loggerNames;
+    QLoguruStringTable _fileNames;
+    std::uint64_t _firstId = 0;
+    mutable std::shared_mutex _mutex;
+
+    // Kept once created, it may hold rows after spilling stopped.
+    std::unique_ptr<QLoguruSpillStore> _spill;
+    std::shared_ptr<pending_spill_t> _pendingSpill;
+    bool _isSpilling = false;
+    std::size_t _memoryRows = defaultMemoryRows;
+    std::size_t _segmentRows = QLoguruSpillStore::defaultSegmentRows;
+};
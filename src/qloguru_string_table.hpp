@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * Interning table assigning a small, stable integer id to every distinct
+ * string. A process only has a handful of thread and file names, so rows
+ * store the id and everything keyed by the name can be a flat array indexed
+ * by it.
+ *
+ * Ids are never reused and never invalidated, the table only grows.
+ */
+class QLoguruStringTable
+{
+public:
+    static constexpr std::uint32_t npos = UINT32_MAX;
+
+public:
+    QLoguruStringTable() = default;
+    QLoguruStringTable(const QLoguruStringTable&) = delete;
+    QLoguruStringTable& operator=(const QLoguruStringTable&) = delete;
+
+    /**
+     * @brief Get the id of the string, adding it if it's not known yet.
+     */
+    std::uint32_t intern(std::string_view text)
+    {
+        auto it = _ids.find(text);
+        if (it != _ids.end())
+            return it->second;
+
+        auto id = static_cast<std::uint32_t>(_strings.size());
+        // The deque never relocates its elements, so the key can refer to the
+        // stored string.
+        const std::string& stored = _strings.emplace_back(text);
+        _ids.emplace(stored, id);
+        return id;
+    }
+
+    /**
+     * @brief Get the id of the string or npos if it's not known.
+     */
+    std::uint32_t find(std::string_view text) const
+    {
+        auto it = _ids.find(text);
+        return it != _ids.end() ? it->second : npos;
+    }
+
+    std::string_view operator[](std::uint32_t id) const
+    {
+        return _strings[ id ];
+    }
+
+    std::size_t size() const { return _strings.size(); }
+
+    std::size_t memoryUsage() const
+    {
+        std::size_t result = 0;
+        for (const std::string& text : _strings)
+            result += sizeof(std::string) + text.capacity() +
+                      sizeof(std::string_view) + sizeof(std::uint32_t);
+        return result;
+    }
+
+private:
+    std::deque<std::string> _strings;
+    std::unordered_map<std::string_view, std::uint32_t> _ids;
+};
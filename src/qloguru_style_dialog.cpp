@@ -14,6 +14,11 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
     QLineEdit* loggerNameEdit = new QLineEdit();
     loggerNameEdit->setPlaceholderText("Logger name");
     loggerNameEdit->setObjectName("loggerNameEdit");
+    QLineEdit* conditionEdit = new QLineEdit();
+    conditionEdit->setPlaceholderText(
+        "Or a condition, e.g. level>=error msg:deadline"
+    );
+    conditionEdit->setObjectName("conditionEdit");
     QLineEdit* backgroundColorEdit = new QLineEdit();
     backgroundColorEdit->setPlaceholderText("Background color");
     backgroundColorEdit->setObjectName("backgroundColorEdit");
@@ -24,6 +29,7 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
     checkBoxBold->setObjectName("checkBoxBold");
 
     layout->addWidget(loggerNameEdit);
+    layout->addWidget(conditionEdit);
     layout->addWidget(backgroundColorEdit);
     layout->addWidget(textColorEdit);
     layout->addWidget(checkBoxBold);
@@ -33,18 +39,11 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
     layout->addWidget(buttonBox);
     buttonBox->setObjectName("buttonBox");
 
-    connect(
-        loggerNameEdit,
-        &QLineEdit::textChanged,
-        this,
-        [ this, backgroundColorEdit, textColorEdit, checkBoxBold ](
-            const QString& name
-        ) {
-        std::string namestdstr = name.toStdString();
-        auto bg = _model->getLoggerBackground(namestdstr);
-        auto fg = _model->getLoggerForeground(namestdstr);
-        auto fnt = _model->getLoggerFont(namestdstr);
-
+    auto showStyle = [ backgroundColorEdit, textColorEdit, checkBoxBold ](
+                         std::optional<QBrush> bg,
+                         std::optional<QColor> fg,
+                         std::optional<QFont> fnt
+                     ) {
         if (bg)
             backgroundColorEdit->setText(bg.value().color().name());
         else
@@ -61,6 +60,33 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
         } else {
             checkBoxBold->setChecked(false);
         }
+    };
+
+    connect(
+        loggerNameEdit,
+        &QLineEdit::textChanged,
+        this,
+        [ this, showStyle ](const QString& name) {
+        std::string namestdstr = name.toStdString();
+        showStyle(
+            _model->getLoggerBackground(namestdstr),
+            _model->getLoggerForeground(namestdstr),
+            _model->getLoggerFont(namestdstr)
+        );
+        });
+
+    connect(
+        conditionEdit,
+        &QLineEdit::textChanged,
+        this,
+        [ this, showStyle ](const QString& condition) {
+        for (const QLoguruStyleRule& rule : _model->getStyleRules()) {
+            if (rule.condition == condition) {
+                showStyle(rule.background, rule.foreground, rule.font);
+                return;
+            }
+        }
+        showStyle(std::nullopt, std::nullopt, std::nullopt);
         });
 
     connect(
@@ -69,6 +95,7 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
         this,
         [ this,
           loggerNameEdit,
+          conditionEdit,
           backgroundColorEdit,
           textColorEdit,
           checkBoxBold ]() {
@@ -76,6 +103,7 @@ QLoguruStyleDialog::QLoguruStyleDialog(QWidget* parent)
             reject();
 
         _result.loggerName = loggerNameEdit->text().toStdString();
+        _result.condition = conditionEdit->text();
 
         if (!backgroundColorEdit->text().isEmpty())
             _result.backgroundColor = QColor(backgroundColorEdit->text());
@@ -12,6 +12,8 @@ class QLoguruStyleDialog : public QDialog
 public:
     struct Style {
         std::string loggerName;
+        // Styles the messages matching it rather than the logger if set.
+        QString condition;
         std::optional<QColor> backgroundColor;
         std::optional<QColor> textColor;
         bool fontBold;
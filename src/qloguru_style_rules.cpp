@@ -0,0 +1,143 @@
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "qloguru_model.hpp"
+#include "qloguru_style_rules.hpp"
+
+namespace
+{
+
+static constexpr std::size_t evaluationBlockSize = 65536; // rows
+static constexpr std::size_t lockSliceSize = 4096;        // rows
+
+// Shared with the workers, which may only get to run once the evaluation is
+// over and must then find nothing left to do.
+struct evaluation_t {
+    std::vector<QLoguruFilter> filters;
+    std::vector<std::uint16_t> ids;
+    std::size_t blockCount = 0;
+    std::atomic<std::size_t> nextBlock = 0;
+    std::size_t doneBlocks = 0;
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+} // namespace
+
+void QLoguruStyleRules::setRules(
+    std::vector<QLoguruStyleRule> rules, const QLoguruModel& model
+)
+{
+    if (rules.size() > maxRules)
+        rules.resize(maxRules);
+
+    _rules = std::move(rules);
+    _filters.clear();
+    for (const QLoguruStyleRule& rule : _rules)
+        _filters.emplace_back(rule.condition, false, false);
+
+    const QLoguruStorage& storage = model.storage();
+    _firstId = storage.firstId();
+    _ids.clear();
+    if (_rules.empty() || storage.empty())
+        return;
+
+    for (const QLoguruFilter& filter : _filters)
+        filter.prepare(model);
+
+    auto evaluation = std::make_shared<evaluation_t>();
+    evaluation->filters = _filters;
+    evaluation->ids.resize(storage.size());
+    evaluation->blockCount =
+        (storage.size() + evaluationBlockSize - 1) / evaluationBlockSize;
+
+    const QLoguruModel* source = &model;
+    auto work = [ evaluation, source ]() {
+        // Every worker has its own copy, the caches are not shared.
+        std::vector<QLoguruFilter> filters;
+        for (;;) {
+            std::size_t block = evaluation->nextBlock.fetch_add(1);
+            if (block >= evaluation->blockCount)
+                break;
+
+            if (filters.empty())
+                filters = evaluation->filters;
+
+            std::size_t begin = block * evaluationBlockSize;
+            std::size_t end = std::min(
+                begin + evaluationBlockSize, evaluation->ids.size()
+            );
+            // Same slices as the filter scans, a reader never holds the
+            // lock for long.
+            for (std::size_t slice = begin; slice < end;
+                 slice += lockSliceSize) {
+                std::shared_lock lock(source->storage().mutex());
+                for (std::size_t row = slice;
+                     row < std::min(slice + lockSliceSize, end);
+                     ++row)
+                    evaluation->ids[ row ] = evaluate(filters, *source, row);
+            }
+
+            std::lock_guard lock(evaluation->mutex);
+            if (++evaluation->doneBlocks == evaluation->blockCount)
+                evaluation->finished.notify_all();
+        }
+    };
+
+    // The calling thread takes its share, the evaluation doesn't depend on
+    // the pool being free.
+    int helpers = std::min(
+        QThread::idealThreadCount(), static_cast<int>(evaluation->blockCount)
+    ) - 1;
+    for (int i = 0; i < helpers; ++i)
+        QThreadPool::globalInstance()->start(work);
+    work();
+
+    {
+        std::unique_lock lock(evaluation->mutex);
+        evaluation->finished.wait(lock, [ & ]() {
+            return evaluation->doneBlocks == evaluation->blockCount;
+        });
+    }
+
+    _ids.assign(evaluation->ids.begin(), evaluation->ids.end());
+}
+
+void QLoguruStyleRules::append(const QLoguruModel& model, std::size_t row)
+{
+    if (_rules.empty())
+        return;
+
+    _ids.push_back(evaluate(_filters, model, row));
+}
+
+void QLoguruStyleRules::evict(std::uint64_t firstId)
+{
+    if (firstId <= _firstId)
+        return;
+
+    std::size_t count =
+        std::min<std::uint64_t>(firstId - _firstId, _ids.size());
+    _ids.erase(_ids.begin(), _ids.begin() + count);
+    _firstId = firstId;
+}
+
+std::uint16_t QLoguruStyleRules::evaluate(
+    const std::vector<QLoguruFilter>& filters,
+    const QLoguruModel& model,
+    std::size_t row
+)
+{
+    for (std::size_t i = 0; i < filters.size(); ++i) {
+        if (filters[ i ].isValid() && filters[ i ].accepts(model, row))
+            return static_cast<std::uint16_t>(i + 1);
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "qloguru/qloguru_style_rule.hpp"
+#include "qloguru_filter.hpp"
+
+class QLoguruModel;
+
+/**
+ * Style id of every row, resolved from the style rules.
+ *
+ * The rules are evaluated once per row as it's appended, and once over all
+ * the rows (in parallel) when they change. Painting a row then only looks up
+ * the style through its id, no condition is evaluated. Without rules no id
+ * is kept at all.
+ */
+class QLoguruStyleRules
+{
+public:
+    static constexpr std::size_t maxRules = UINT16_MAX;
+
+public:
+    /**
+     * @brief Replace the rules and evaluate them for every row of the model.
+     */
+    void setRules(std::vector<QLoguruStyleRule> rules, const QLoguruModel& model);
+    const std::vector<QLoguruStyleRule>& rules() const { return _rules; }
+    bool empty() const { return _rules.empty(); }
+
+    /**
+     * @brief Evaluate the rules for a row just appended to the model.
+     */
+    void append(const QLoguruModel& model, std::size_t row);
+    void evict(std::uint64_t firstId);
+
+    /**
+     * @brief Get the rule the row with the id matches, nullptr if none.
+     */
+    const QLoguruStyleRule* rule(std::uint64_t id) const
+    {
+        if (id < _firstId || id - _firstId >= _ids.size())
+            return nullptr;
+
+        std::uint16_t styleId = _ids[ id - _firstId ];
+        return styleId == 0 ? nullptr : &_rules[ styleId - 1 ];
+    }
+
+private:
+    static std::uint16_t evaluate(
+        const std::vector<QLoguruFilter>& filters,
+        const QLoguruModel& model,
+        std::size_t row
+    );
+
+private:
+    std::vector<QLoguruStyleRule> _rules;
+    std::vector<QLoguruFilter> _filters;
+    // 0 for the rows matching no rule, the index of the rule plus one
+    // otherwise.
+    std::deque<std::uint16_t> _ids;
+    std::uint64_t _firstId = 0;
+};
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#include "qloguru_substring_search.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || \
+    defined(_M_IX86)
+#define QLOGURU_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define QLOGURU_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define QLOGURU_TARGET_AVX2
+#endif
+
+namespace
+{
+
+using search_t = bool (*)(std::string_view, std::string_view, bool);
+
+constexpr char lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c | 0x20) : c;
+}
+
+constexpr bool isLetter(char c) { return lower(c) >= 'a' && lower(c) <= 'z'; }
+
+// The needle is already lowercase when ignoring the case.
+bool equal(const char* text, const char* needle, std::size_t size, bool fold)
+{
+    if (!fold)
+        return std::memcmp(text, needle, size) == 0;
+
+    for (std::size_t i = 0; i < size; ++i) {
+        if (lower(text[ i ]) != needle[ i ])
+            return false;
+    }
+    return true;
+}
+
+bool searchScalar(std::string_view haystack, std::string_view needle, bool fold)
+{
+    if (!fold)
+        return haystack.find(needle) != std::string_view::npos;
+
+    for (std::size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (equal(haystack.data() + i, needle.data(), needle.size(), true))
+            return true;
+    }
+    return false;
+}
+
+// Checks the candidate positions of a block, the first and last bytes are
+// known to match already.
+bool verify(
+    std::uint32_t mask,
+    const char* text,
+    std::string_view needle,
+    bool fold
+)
+{
+    while (mask != 0) {
+        std::size_t offset = std::countr_zero(mask);
+        if (equal(text + offset + 1, needle.data() + 1, needle.size() - 2, fold))
+            return true;
+        mask &= mask - 1;
+    }
+    return false;
+}
+
+#ifdef QLOGURU_X86
+
+// Setting the 0x20 bit lowercases a letter, it's only applied when comparing
+// against letters. Other bytes can't produce false candidates that way.
+char foldMask(char c, bool fold) { return fold && isLetter(c) ? 0x20 : 0; }
+
+bool searchSse2(std::string_view haystack, std::string_view needle, bool fold)
+{
+    std::size_t size = needle.size();
+    if (size < 2 || haystack.size() < size + 15)
+        return searchScalar(haystack, needle, fold);
+
+    const __m128i first = _mm_set1_epi8(needle.front());
+    const __m128i last = _mm_set1_epi8(needle.back());
+    const __m128i firstMask = _mm_set1_epi8(foldMask(needle.front(), fold));
+    const __m128i lastMask = _mm_set1_epi8(foldMask(needle.back(), fold));
+
+    const char* text = haystack.data();
+    std::size_t i = 0;
+    for (; i + size + 15 <= haystack.size(); i += 16) {
+        __m128i blockFirst = _mm_or_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i)),
+            firstMask
+        );
+        __m128i blockLast = _mm_or_si128(
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(text + i + size - 1)
+            ),
+            lastMask
+        );
+        __m128i eq = _mm_and_si128(
+            _mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)
+        );
+        auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(eq));
+        if (verify(mask, text + i, needle, fold))
+            return true;
+    }
+
+    return searchScalar(haystack.substr(i), needle, fold);
+}
+
+QLOGURU_TARGET_AVX2 bool
+searchAvx2(std::string_view haystack, std::string_view needle, bool fold)
+{
+    std::size_t size = needle.size();
+    if (size < 2 || haystack.size() < size + 31)
+        return searchSse2(haystack, needle, fold);
+
+    const __m256i first = _mm256_set1_epi8(needle.front());
+    const __m256i last = _mm256_set1_epi8(needle.back());
+    const __m256i firstMask = _mm256_set1_epi8(foldMask(needle.front(), fold));
+    const __m256i lastMask = _mm256_set1_epi8(foldMask(needle.back(), fold));
+
+    const char* text = haystack.data();
+    std::size_t i = 0;
+    for (; i + size + 31 <= haystack.size(); i += 32) {
+        __m256i blockFirst = _mm256_or_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i)),
+            firstMask
+        );
+        __m256i blockLast = _mm256_or_si256(
+            _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(text + i + size - 1)
+            ),
+            lastMask
+        );
+        __m256i eq = _mm256_and_si256(
+            _mm256_cmpeq_epi8(blockFirst, first),
+            _mm256_cmpeq_epi8(blockLast, last)
+        );
+        auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(eq));
+        if (verify(mask, text + i, needle, fold))
+            return true;
+    }
+
+    return searchSse2(haystack.substr(i), needle, fold);
+}
+
+bool hasAvx2()
+{
+#ifdef _MSC_VER
+    int info[ 4 ];
+    __cpuid(info, 0);
+    if (info[ 0 ] < 7)
+        return false;
+
+    // AVX2 also needs the OS to save the YMM registers.
+    __cpuid(info, 1);
+    bool osxsave = (info[ 2 ] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[ 1 ] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+search_t selectSearch() { return hasAvx2() ? searchAvx2 : searchSse2; }
+
+#else
+
+search_t selectSearch() { return searchScalar; }
+
+#endif
+
+} // namespace
+
+QLoguruSubstringSearch::QLoguruSubstringSearch(
+    std::string_view needle, bool isCaseSensitive
+)
+    : _needle(needle)
+    , _isCaseSensitive(isCaseSensitive)
+    , _isAscii(std::all_of(needle.begin(), needle.end(), [](char c) {
+        return static_cast<unsigned char>(c) < 0x80;
+    }))
+{
+    if (!_isCaseSensitive)
+        std::transform(_needle.begin(), _needle.end(), _needle.begin(), lower);
+}
+
+bool QLoguruSubstringSearch::contains(std::string_view haystack) const
+{
+    static const search_t search = selectSearch();
+
+    if (_needle.empty())
+        return true;
+
+    if (haystack.size() < _needle.size())
+        return false;
+
+    return search(haystack, _needle, !_isCaseSensitive);
+}
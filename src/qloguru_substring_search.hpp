@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * Fixed string search over raw UTF-8 bytes.
+ *
+ * On x86 candidates are found 16 or 32 bytes at a time by comparing the first
+ * and the last byte of the needle against the haystack at the matching
+ * distance, only the positions where both match are compared completely. The
+ * AVX2 variant is picked at runtime when the CPU supports it, SSE2 is the
+ * baseline and other architectures use a scalar search.
+ *
+ * Case insensitive search folds ASCII letters only, it's meant for needles
+ * without any non-ASCII characters (see isAscii()).
+ */
+class QLoguruSubstringSearch
+{
+public:
+    QLoguruSubstringSearch() = default;
+    QLoguruSubstringSearch(std::string_view needle, bool isCaseSensitive);
+
+    bool contains(std::string_view haystack) const;
+
+    bool isCaseSensitive() const { return _isCaseSensitive; }
+
+    /**
+     * @brief Check whether the needle is made of ASCII characters only.
+     */
+    bool isAscii() const { return _isAscii; }
+
+private:
+    // ASCII lowercase when searching case insensitively.
+    std::string _needle;
+    bool _isCaseSensitive = true;
+    bool _isAscii = true;
+};
@@ -1,11 +1,16 @@
 #include <QComboBox>
 #include <QCompleter>
+#include <QLabel>
 #include <QLayout>
 #include <QLineEdit>
-#include <QRegularExpression>
+#include <QMenu>
 #include <QSettings>
 #include <QStringListModel>
+#include <QToolButton>
+#include <QTreeWidget>
+#include <QWidgetAction>
 
+#include "qloguru_filter.hpp"
 #include "qloguru_toolbar.hpp"
 
 QLoguruToolBar::QLoguruToolBar(QWidget* parent)
@@ -13,6 +18,8 @@ QLoguruToolBar::QLoguruToolBar(QWidget* parent)
     , _filterWidget(new QLineEdit(this))
     , _clearHistory(new QAction("Clear History", this))
     , _autoScrollPolicy(new QComboBox(this))
+    , _filterStatus(new QLabel(this))
+    , _facets(new QTreeWidget(this))
     , _completerData(new QStringListModel(this))
     , _completer(new QCompleter(_completerData, this))
 {
@@ -27,11 +34,29 @@ QLoguruToolBar::QLoguruToolBar(QWidget* parent)
     _regexAction->setCheckable(true);
     _regexAction->setObjectName("regexAction");
 
+    _filterStatus->setObjectName("filterStatus");
+    addWidget(_filterStatus);
+
     _clearHistory->setObjectName("clearHistoryAction");
 
     _styleAction = addAction("Set style");
     _styleAction->setObjectName("styleAction");
 
+    // The facets pop up from a button, next to the filter they complement.
+    _facets->setObjectName("facetTree");
+    _facets->setHeaderLabels({ "Facet", "Messages" });
+    _facets->setMinimumSize(280, 320);
+    auto facetMenu = new QMenu(this);
+    auto facetAction = new QWidgetAction(facetMenu);
+    facetAction->setDefaultWidget(_facets);
+    facetMenu->addAction(facetAction);
+    auto facetButton = new QToolButton(this);
+    facetButton->setObjectName("facetButton");
+    facetButton->setText("Facets");
+    facetButton->setMenu(facetMenu);
+    facetButton->setPopupMode(QToolButton::InstantPopup);
+    addWidget(facetButton);
+
     _autoScrollPolicy->setObjectName("_autoScrollPolicy");
     _autoScrollPolicy->addItems(
         { "Manual Scroll", "Scroll To Bottom", "Smart Scroll" }
@@ -40,7 +65,7 @@ QLoguruToolBar::QLoguruToolBar(QWidget* parent)
 
     auto lineEdit = static_cast<QLineEdit*>(_filterWidget);
 
-    lineEdit->setPlaceholderText("Filter");
+    lineEdit->setPlaceholderText("Filter, e.g. level>=warning logger:main");
 
     _completer->setCaseSensitivity(Qt::CaseInsensitive);
     _completer->setCompletionMode(QCompleter::PopupCompletion);
@@ -111,6 +136,10 @@ QAction* QLoguruToolBar::style() { return _styleAction; }
 
 QComboBox* QLoguruToolBar::autoScrollPolicy() { return _autoScrollPolicy; }
 
+QLabel* QLoguruToolBar::filterStatus() { return _filterStatus; }
+
+QTreeWidget* QLoguruToolBar::facets() { return _facets; }
+
 #pragma endregion
 
 QLoguruToolBar::FilteringSettings QLoguruToolBar::filteringSettings() const
@@ -124,15 +153,11 @@ void QLoguruToolBar::checkInputValidity()
 {
     FilteringSettings settings = filteringSettings();
 
-    if (!settings.isRegularExpression) {
-        // everything is ok, the input text is valid
-        _filterWidget->setPalette(QWidget::palette());
-        _filterWidget->setToolTip("");
-        return;
-    }
-
-    QRegularExpression regex(settings.text);
-    if (regex.isValid()) {
+    // Both regular expressions and queries can be malformed.
+    QLoguruFilter filter(
+        settings.text, settings.isRegularExpression, settings.isCaseSensitive
+    );
+    if (filter.isValid()) {
         _filterWidget->setPalette(QWidget::palette());
         _filterWidget->setToolTip("");
         return;
@@ -141,7 +166,7 @@ void QLoguruToolBar::checkInputValidity()
     QPalette palette = _filterWidget->palette();
     palette.setColor(QPalette::Text, Qt::red);
     _filterWidget->setPalette(palette);
-    _filterWidget->setToolTip(regex.errorString());
+    _filterWidget->setToolTip(filter.errorString());
 }
 
 void QLoguruToolBar::clearCompleterHistory()
@@ -9,6 +9,7 @@ class QAction;
 class QCompleter;
 class QAbstractItemModel;
 class QSettings;
+class QTreeWidget;
 
 class QLoguruToolBar
     : public QToolBar
@@ -34,6 +35,8 @@ public:
     QAction* clearHistory() override;
     QAction* style() override;
     QComboBox* autoScrollPolicy() override;
+    QLabel* filterStatus() override;
+    QTreeWidget* facets() override;
 #pragma endregion
 
     FilteringSettings filteringSettings() const;
@@ -56,6 +59,8 @@ private:
     QAction* _clearHistory;
     QAction* _styleAction;
     QComboBox* _autoScrollPolicy;
+    QLabel* _filterStatus;
+    QTreeWidget* _facets;
     QAbstractItemModel* _completerData;
     QCompleter* _completer;
 };
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <iterator>
+
+#include "qloguru_trigram_index.hpp"
+
+namespace
+{
+
+// Rough per list cost of the hash map node and the vector.
+static constexpr std::size_t listOverhead = 64;
+
+std::uint32_t fold(char c)
+{
+    auto byte = static_cast<unsigned char>(c);
+    return byte >= 'A' && byte <= 'Z' ? byte | 0x20 : byte;
+}
+
+std::uint32_t trigram(const char* text)
+{
+    return (fold(text[ 0 ]) << 16) | (fold(text[ 1 ]) << 8) | fold(text[ 2 ]);
+}
+
+} // namespace
+
+QLoguruTrigramIndex::QLoguruTrigramIndex(std::size_t memoryLimit)
+    : _memoryLimit(memoryLimit)
+{
+}
+
+void QLoguruTrigramIndex::append(std::uint64_t id, std::string_view message)
+{
+    if (id != _endId || _firstId == _endId) {
+        clear();
+        _firstId = id;
+        _compactedBlock = static_cast<std::uint32_t>(id / blockSize);
+    }
+    _endId = id + 1;
+
+    auto block = static_cast<std::uint32_t>(id / blockSize);
+    for (std::size_t i = 0; i + 3 <= message.size(); ++i) {
+        list_t& list = _lists[ trigram(message.data() + i) ];
+        if (list.empty() || list.back() != block) {
+            list.push_back(block);
+            ++_entries;
+        }
+    }
+
+    if (memoryUsage() > _memoryLimit)
+        shrink();
+}
+
+void QLoguruTrigramIndex::evict(std::uint64_t firstId)
+{
+    if (firstId <= _firstId)
+        return;
+
+    if (firstId >= _endId) {
+        clear();
+        _firstId = _endId = firstId;
+        return;
+    }
+
+    _firstId = firstId;
+
+    // Dropping the dead blocks touches every list, it's only worth it once
+    // they make up half of the index.
+    auto firstBlock = static_cast<std::uint32_t>(_firstId / blockSize);
+    auto endBlock = static_cast<std::uint32_t>(_endId / blockSize) + 1;
+    if ((firstBlock - _compactedBlock) * 2 >= endBlock - _compactedBlock)
+        compact();
+}
+
+void QLoguruTrigramIndex::clear()
+{
+    _lists.clear();
+    _entries = 0;
+    _firstId = _endId;
+    _compactedBlock = static_cast<std::uint32_t>(_firstId / blockSize);
+}
+
+std::optional<std::vector<std::uint32_t>> QLoguruTrigramIndex::candidateBlocks(
+    std::string_view literal
+) const
+{
+    if (literal.size() < 3)
+        return std::nullopt;
+
+    std::vector<std::uint32_t> keys;
+    for (std::size_t i = 0; i + 3 <= literal.size(); ++i)
+        keys.push_back(trigram(literal.data() + i));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<const list_t*> lists;
+    for (std::uint32_t key : keys) {
+        auto it = _lists.find(key);
+        if (it == _lists.end())
+            return std::vector<std::uint32_t>();
+        lists.push_back(&it->second);
+    }
+
+    // Start with the shortest list, the result only shrinks from there.
+    std::sort(lists.begin(), lists.end(), [](const list_t* a, const list_t* b) {
+        return a->size() < b->size();
+    });
+
+    auto firstBlock = static_cast<std::uint32_t>(_firstId / blockSize);
+    const list_t& shortest = *lists.front();
+    std::vector<std::uint32_t> result(
+        std::lower_bound(shortest.begin(), shortest.end(), firstBlock),
+        shortest.end()
+    );
+
+    std::vector<std::uint32_t> intersection;
+    for (std::size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        intersection.clear();
+        std::set_intersection(
+            result.begin(),
+            result.end(),
+            lists[ i ]->begin(),
+            lists[ i ]->end(),
+            std::back_inserter(intersection)
+        );
+        result.swap(intersection);
+    }
+
+    return result;
+}
+
+void QLoguruTrigramIndex::setMemoryLimit(std::size_t memoryLimit)
+{
+    _memoryLimit = memoryLimit;
+    while (memoryUsage() > _memoryLimit && _firstId != _endId)
+        shrink();
+}
+
+std::size_t QLoguruTrigramIndex::memoryUsage() const
+{
+    return _entries * sizeof(std::uint32_t) + _lists.size() * listOverhead;
+}
+
+void QLoguruTrigramIndex::compact()
+{
+    auto firstBlock = static_cast<std::uint32_t>(_firstId / blockSize);
+
+    _entries = 0;
+    for (auto it = _lists.begin(); it != _lists.end();) {
+        list_t& list = it->second;
+        list.erase(
+            list.begin(), std::lower_bound(list.begin(), list.end(), firstBlock)
+        );
+        if (list.empty()) {
+            it = _lists.erase(it);
+            continue;
+        }
+
+        _entries += list.size();
+        ++it;
+    }
+
+    _compactedBlock = firstBlock;
+}
+
+void QLoguruTrigramIndex::shrink()
+{
+    // Whole blocks only, so the first covered block is complete.
+    std::uint64_t firstId = _firstId + (_endId - _firstId) / 2;
+    firstId = (firstId + blockSize - 1) / blockSize * blockSize;
+    if (firstId >= _endId) {
+        clear();
+        return;
+    }
+
+    _firstId = firstId;
+    compact();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Trigram index over the messages of the storage.
+ *
+ * Rows are grouped in blocks of blockSize consecutive ids, every trigram
+ * (ASCII letters folded to lowercase) maps to the sorted list of blocks
+ * containing it at least once. A literal can only be in the blocks present in
+ * the lists of all its trigrams, so searching it comes down to intersecting
+ * a few lists and checking the rows of the remaining blocks.
+ *
+ * Evicted rows are dropped from the lists lazily. When the index grows past
+ * its memory limit it stops covering its oldest half, the rows before
+ * firstId() must then be checked without its help.
+ */
+class QLoguruTrigramIndex
+{
+public:
+    static constexpr std::uint64_t blockSize = 64;
+    static constexpr std::size_t defaultMemoryLimit = 256 << 20;
+
+public:
+    explicit QLoguruTrigramIndex(std::size_t memoryLimit = defaultMemoryLimit);
+
+    /**
+     * @brief Index the message of the row with the given id.
+     *
+     * Ids are expected to follow each other, a gap starts the index over.
+     */
+    void append(std::uint64_t id, std::string_view message);
+
+    /**
+     * @brief Forget the rows before the given id.
+     */
+    void evict(std::uint64_t firstId);
+    void clear();
+
+    /**
+     * @brief Range of ids covered by the index.
+     */
+    std::uint64_t firstId() const { return _firstId; }
+    std::uint64_t endId() const { return _endId; }
+
+    /**
+     * @brief Get the blocks which may contain the literal, in order.
+     *
+     * Returns nothing if the index can't tell, i.e. the literal is shorter
+     * than a trigram.
+     */
+    std::optional<std::vector<std::uint32_t>> candidateBlocks(
+        std::string_view literal
+    ) const;
+
+    void setMemoryLimit(std::size_t memoryLimit);
+    std::size_t memoryLimit() const { return _memoryLimit; }
+
+    /**
+     * @brief Approximate number of bytes held by the index.
+     */
+    std::size_t memoryUsage() const;
+
+private:
+    using list_t = std::vector<std::uint32_t>;
+
+    void compact();
+    void shrink();
+
+private:
+    std::unordered_map<std::uint32_t, list_t> _lists;
+    std::size_t _entries = 0;
+    std::size_t _memoryLimit;
+
+    std::uint64_t _firstId = 0;
+    std::uint64_t _endId = 0;
+    // Lists may still hold blocks before this one.
+    std::uint32_t _compactedBlock = 0;
+};
@@ -1,54 +1,164 @@
 #pragma once
 #include "qloguru_model.hpp"
-#include <regex>
+#include "qloguru_preamble_parser.hpp"
+#include "qloguru_ring_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <loguru.hpp>
 #include <QObject>
 #include <QString>
 #include <QMetaObject>
+#include <QThread>
 
 class QtLoggerSink : public QObject {
     Q_OBJECT
 public:
-    explicit QtLoggerSink(QLoguruModel* model, QObject* parent = nullptr)
-        : QObject(parent), _model(model)
+    static constexpr std::size_t defaultCapacity = 65536;
+
+    explicit QtLoggerSink(
+        QLoguruModel* model,
+        std::size_t capacity = defaultCapacity,
+        QObject* parent = nullptr
+    )
+        : QObject(parent), _model(model), _buffer(capacity)
+        , _callbackId("qt_logger_sink_" + std::to_string(reinterpret_cast<std::uintptr_t>(this)))
     {
-        loguru::add_callback("qt_logger_sink", QtLoggerSink::callback, _model, loguru::Verbosity_INFO);
+        loguru::add_callback(_callbackId.c_str(), QtLoggerSink::callback, this, loguru::Verbosity_INFO);
     }
 
     static void callback(void* user_data, const loguru::Message& message)
     {
         if (!user_data) return;
+
+        // Everything is taken from the structured fields of the message and
+        // the clocks read here, the formatted preamble is not parsed on the
+        // logging thread.
+        auto now = std::chrono::system_clock::now();
+        auto steady = std::chrono::steady_clock::now();
+        auto uptime = steady - startTime(steady, message);
+
         QLoguruModel::entry_t entry;
-        std::regex pattern(R"(.*?(\d{2}:\d{2}:\d{2}\.\d{3})\s+\(\s*([0-9.]+s)\)\s+\[\s*(.*?)\s*\])");
-        std::smatch match;
-        std::string preamble(message.preamble);
-        if (std::regex_search(preamble, match, pattern)) {
-            std::string time = match[1];
-            std::string elapsed = match[2];
-            std::string thread_id = match[3];
-            entry.time = time;
-            entry.elapsed = elapsed;
-            entry.loggerName = thread_id;
-        }else {
-            return;
-        }
+        entry.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now.time_since_epoch()).count();
+        entry.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            uptime).count();
         entry.level = static_cast<int>(message.verbosity);
-        entry.message = message.message;
-        // make sure addEntry is call by QT GUI thread
-        auto model = (QLoguruModel*)user_data;
-        QMetaObject::invokeMethod(model, [model, entry]() {
-            model->addEntry(entry);
-        }, Qt::QueuedConnection);
+        entry.line = message.line;
+
+        // Same width loguru uses for the thread name in its preamble.
+        char threadName[ LOGURU_THREADNAME_WIDTH + 1 ] = {};
+        loguru::get_thread_name(threadName, sizeof(threadName), true);
+        entry.loggerName = threadName;
+
+        if (message.filename) {
+            std::string_view file(message.filename);
+            std::size_t separator = file.find_last_of("/\\");
+            entry.file = separator == std::string_view::npos
+                             ? file
+                             : file.substr(separator + 1);
+        }
+
+        entry.message = message.prefix;
+        entry.message += message.message;
+        static_cast<QtLoggerSink*>(user_data)->enqueue(std::move(entry));
     }
 
     ~QtLoggerSink() override {
-        loguru::remove_callback("qt_logger_sink");
+        detach();
     }
 
     void invalidate() { _model = nullptr; }
 
+    /**
+     * Stop receiving messages from loguru. Once this returns no logging
+     * thread is inside the callback anymore, since loguru serializes the
+     * callbacks and their removal with its own mutex.
+     */
+    void detach()
+    {
+        if (_attached.exchange(false))
+            loguru::remove_callback(_callbackId.c_str());
+    }
+
+    /**
+     * Move the buffered messages into the model. Always called from the GUI
+     * thread, either by the coalesced wakeup or synchronously.
+     */
+    void drain()
+    {
+        // Reset the flag before popping: anything pushed after this point
+        // schedules a new wakeup, anything pushed before is drained below.
+        _drainScheduled.store(false, std::memory_order_release);
+
+        // Bound the work done per wakeup so a burst can't freeze the UI; the
+        // remainder is picked up by the next event loop iteration.
+        std::size_t budget = _buffer.capacity();
+        QLoguruModel::entry_t entry;
+        while (budget-- > 0 && _buffer.tryPop(entry))
+            _batch.push_back(std::move(entry));
+
+        // The whole batch reaches the model (and the proxy and the view
+        // behind it) as one removal and one insertion.
+        if (_model)
+            _model->addEntries(_batch);
+        _batch.clear();
+
+        if (_buffer.size() > 0)
+            scheduleDrain();
+    }
+
+    QLoguruRingBuffer<QLoguruModel::entry_t>& buffer() { return _buffer; }
+    const QLoguruRingBuffer<QLoguruModel::entry_t>& buffer() const { return _buffer; }
+
+private:
+    /**
+     * loguru only exposes its start time through the uptime it formats in
+     * the preamble. It's worked out once, from the first message, so the
+     * elapsed times agree with the ones loguru writes; without an uptime in
+     * the preamble they count from the first message.
+     */
+    static std::chrono::steady_clock::time_point startTime(
+        std::chrono::steady_clock::time_point now,
+        const loguru::Message& message
+    )
+    {
+        static const auto start = [ & ]() {
+            QLoguruPreambleParser::preamble_t preamble;
+            QLoguruPreambleParser::parse(message.preamble, preamble);
+            return now - std::chrono::nanoseconds(
+                QLoguruPreambleParser::toNanoseconds(preamble.uptime));
+        }();
+        return start;
+    }
+
+    void enqueue(QLoguruModel::entry_t&& entry)
+    {
+        // Blocking the GUI thread on its own buffer would never end, drain it
+        // in place instead.
+        if (_buffer.policy() == OverflowPolicy::OverflowPolicyBlock &&
+            _buffer.size() >= _buffer.capacity() &&
+            QThread::currentThread() == thread())
+            drain();
+
+        if (_buffer.push(std::move(entry)))
+            scheduleDrain();
+    }
+
+    void scheduleDrain()
+    {
+        // One queued call per batch instead of one per message.
+        if (!_drainScheduled.exchange(true, std::memory_order_acq_rel))
+            QMetaObject::invokeMethod(this, &QtLoggerSink::drain, Qt::QueuedConnection);
+    }
+
 private:
     QLoguruModel* _model;
+    QLoguruRingBuffer<QLoguruModel::entry_t> _buffer;
+    std::vector<QLoguruModel::entry_t> _batch;
+    std::string _callbackId;
+    std::atomic<bool> _attached { true };
+    std::atomic<bool> _drainScheduled { false };
 };
-
@@ -0,0 +1,569 @@
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QPixmap>
+#include <QScrollBar>
+#include <QSortFilterProxyModel>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTreeView>
+#include <regex>
+#include <string>
+
+#include "qloguru_importer.hpp"
+#include "qloguru_log_view.hpp"
+#include "qloguru_model.hpp"
+#include "qloguru_preamble_parser.hpp"
+#include "qloguru_proxy_model.hpp"
+#include "qloguru_regex.hpp"
+#include "qloguru_storage.hpp"
+#include "qloguru_substring_search.hpp"
+
+namespace
+{
+
+static constexpr const char* preambles[] = {
+    "2023-01-01 12:34:56.789 (   0.123s) [main thread     ]            "
+    "main.cpp:42    INFO| ",
+    "2023-01-01 12:34:57.001 (   0.335s) [worker-3        ]          "
+    "worker.cpp:1337  WARN| ",
+    "12:34:58.500 (   1.834s) [io              ]             io.cpp:7      "
+    "ERR| ",
+};
+
+// The preamble parsing the sink used to do for every message.
+bool parseWithRegex(const char* text, std::string& time, std::string& thread)
+{
+    std::regex pattern(
+        R"(.*?(\d{2}:\d{2}:\d{2}\.\d{3})\s+\(\s*([0-9.]+s)\)\s+\[\s*(.*?)\s*\])"
+    );
+    std::smatch match;
+    std::string preamble(text);
+    if (!std::regex_search(preamble, match, pattern))
+        return false;
+
+    time = match[ 1 ];
+    thread = match[ 3 ];
+    return true;
+}
+
+QLoguruStorage::entry_t makeEntry(int index)
+{
+    static const char* threads[] = { "main thread", "worker-1", "worker-2" };
+    return { 1700000000000000000LL + index * 1000LL,
+             index * 1000LL,
+             -(index % 3),
+             "Processed request " + std::to_string(index) + " in 12 ms",
+             threads[ index % 3 ],
+             "worker.cpp",
+             static_cast<unsigned>(index % 500) };
+}
+
+void fillModel(QLoguruModel& model, int rows)
+{
+    std::vector<QLoguruModel::entry_t> entries;
+    entries.reserve(rows);
+    for (int i = 0; i < rows; ++i)
+        entries.push_back(makeEntry(i));
+    model.addEntries(entries);
+}
+
+// Large models are filtered in the background, let the scan publish.
+void waitForFilter(QLoguruProxyModel& proxy)
+{
+    while (proxy.isFiltering())
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+}
+
+} // namespace
+
+class QLoguruBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void preambleRegex()
+    {
+        std::string time;
+        std::string thread;
+        QBENCHMARK {
+            for (const char* preamble : preambles)
+                parseWithRegex(preamble, time, thread);
+        }
+    }
+
+    void preambleScanner()
+    {
+        for (const char* preamble : preambles) {
+            std::string time;
+            std::string thread;
+            QVERIFY(parseWithRegex(preamble, time, thread));
+
+            QLoguruPreambleParser::preamble_t result;
+            QVERIFY(QLoguruPreambleParser::parse(preamble, result));
+            QCOMPARE(std::string(result.time), time);
+            QCOMPARE(std::string(result.thread), thread);
+        }
+
+        QLoguruPreambleParser::preamble_t result;
+        QBENCHMARK {
+            for (const char* preamble : preambles)
+                QLoguruPreambleParser::parse(preamble, result);
+        }
+    }
+
+    void importParse()
+    {
+        // Every kind of preamble, once per line.
+        std::string text;
+        for (int i = 0; i < 100000; ++i) {
+            text += preambles[ i % std::size(preambles) ];
+            text += "Processed request " + std::to_string(i) + "\n";
+        }
+
+        std::vector<QLoguruModel::entry_t> entries;
+        QBENCHMARK {
+            entries.clear();
+            QLoguruImporter::parse(text, QDate::currentDate(), entries);
+        }
+        QVERIFY(!entries.empty());
+    }
+
+    void importFile()
+    {
+        QTemporaryDir directory;
+        QFile file(directory.filePath("bench.log"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        for (int i = 0; i < 1000000; ++i) {
+            file.write(preambles[ 0 ]);
+            file.write("Processed request ");
+            file.write(QByteArray::number(i));
+            file.write("\n");
+        }
+        file.close();
+
+        QLoguruModel model;
+        QLoguruImporter importer(&model);
+        QBENCHMARK {
+            model.clear();
+            QVERIFY(importer.start(file.fileName()));
+            while (importer.isImporting())
+                QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+        QCOMPARE(model.rowCount(), 1000000);
+    }
+
+    void storageMemory_data()
+    {
+        QTest::addColumn<int>("rows");
+        QTest::newRow("1M") << 1000000;
+        QTest::newRow("10M") << 10000000;
+    }
+
+    void storageMemory()
+    {
+        QFETCH(int, rows);
+
+        QLoguruStorage storage;
+        for (int i = 0; i < rows; ++i)
+            storage.append(makeEntry(i));
+
+        QTest::setBenchmarkResult(storage.memoryUsage(), QTest::BytesAllocated);
+
+        // Evicting the first half releases the chunks it occupied.
+        std::size_t before = storage.memoryUsage();
+        storage.popFront(rows / 2);
+        QVERIFY(storage.memoryUsage() < before);
+        QCOMPARE(storage.size(), std::size_t(rows - rows / 2));
+    }
+
+    void captureSave()
+    {
+        QTemporaryDir directory;
+        QString path = directory.filePath("bench.capture");
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QBENCHMARK {
+            QVERIFY(model.saveCapture(path));
+        }
+
+        // The compressed columns take less than the rows in memory.
+        QVERIFY(QFileInfo(path).size() < qint64(model.storage().memoryUsage()));
+    }
+
+    void captureLoad()
+    {
+        QTemporaryDir directory;
+        QString path = directory.filePath("bench.capture");
+        {
+            QLoguruModel model;
+            fillModel(model, 1000000);
+            QVERIFY(model.saveCapture(path));
+        }
+
+        QLoguruModel model;
+        QBENCHMARK {
+            QVERIFY(model.loadCapture(path));
+        }
+        QCOMPARE(model.rowCount(), 1000000);
+    }
+
+    void modelPaint_data()
+    {
+        QTest::addColumn<int>("cacheCapacity");
+        QTest::newRow("uncached") << 0;
+        QTest::newRow("cached") << 16384;
+    }
+
+    void modelPaint()
+    {
+        QFETCH(int, cacheCapacity);
+
+        QLoguruModel model;
+        model.setDisplayCacheCapacity(cacheCapacity);
+        fillModel(model, 1000000);
+
+        // One screen worth of rows, painted over and over.
+        QBENCHMARK {
+            for (int row = 500000; row < 500050; ++row) {
+                for (int column = 0; column < model.columnCount(); ++column)
+                    model.data(model.index(row, column));
+            }
+        }
+    }
+
+    void viewPaint_data()
+    {
+        QTest::addColumn<bool>("lightweight");
+        QTest::newRow("QTreeView") << false;
+        QTest::newRow("QLoguruLogView") << true;
+    }
+
+    void viewPaint()
+    {
+        QFETCH(bool, lightweight);
+
+        QLoguruModel model;
+        fillModel(model, 1000000);
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        QTreeView tree;
+        QLoguruLogView log;
+        QAbstractScrollArea* view = &log;
+        if (lightweight) {
+            log.setModel(&proxy);
+        } else {
+            tree.setRootIsDecorated(false);
+            tree.setModel(&proxy);
+            view = &tree;
+        }
+
+        // Scrolling through the middle of the log, one screen at a time.
+        view->resize(800, 600);
+        QPixmap pixmap(view->size());
+        QScrollBar* bar = view->verticalScrollBar();
+        bar->setValue(bar->maximum() / 2);
+        QBENCHMARK {
+            bar->setValue(bar->value() + bar->pageStep());
+            view->render(&pixmap);
+        }
+    }
+
+    void modelFilter_data()
+    {
+        QTest::addColumn<int>("cacheCapacity");
+        QTest::addColumn<int>("rows");
+        // Every cell of 2k rows stays in the cache, the cells of 200k rows
+        // are evicted before they're asked for again.
+        QTest::newRow("uncached, 2k rows") << 0 << 2000;
+        QTest::newRow("cached, 2k rows") << 16384 << 2000;
+        QTest::newRow("uncached, 200k rows") << 0 << 200000;
+        QTest::newRow("cached, 200k rows") << 16384 << 200000;
+    }
+
+    void modelFilter()
+    {
+        QFETCH(int, cacheCapacity);
+        QFETCH(int, rows);
+
+        QLoguruModel model;
+        model.setDisplayCacheCapacity(cacheCapacity);
+        fillModel(model, rows);
+
+        QSortFilterProxyModel proxy;
+        proxy.setFilterKeyColumn(-1);
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilterFixedString("request 9");
+            proxy.setFilterFixedString("request 1");
+        }
+    }
+
+    void substringSearch_data()
+    {
+        QTest::addColumn<bool>("simd");
+        QTest::addColumn<bool>("caseSensitive");
+        QTest::newRow("QString, case sensitive") << false << true;
+        QTest::newRow("QString, case insensitive") << false << false;
+        QTest::newRow("SIMD, case sensitive") << true << true;
+        QTest::newRow("SIMD, case insensitive") << true << false;
+    }
+
+    void substringSearch()
+    {
+        QFETCH(bool, simd);
+        QFETCH(bool, caseSensitive);
+
+        QLoguruStorage storage;
+        for (int i = 0; i < 1000000; ++i)
+            storage.append(makeEntry(i));
+
+        QString needle("Request 99");
+        QLoguruSubstringSearch search(needle.toStdString(), caseSensitive);
+        Qt::CaseSensitivity cs =
+            caseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+
+        int matches = 0;
+        QBENCHMARK {
+            for (std::size_t row = 0; row < storage.size(); ++row) {
+                std::string_view message = storage.message(row);
+                if (simd)
+                    matches += search.contains(message);
+                else
+                    matches += QString::fromUtf8(message.data(), message.size())
+                                   .contains(needle, cs);
+            }
+        }
+        QVERIFY(caseSensitive ? matches == 0 : matches > 0);
+    }
+
+    void regexSearch_data()
+    {
+        QTest::addColumn<bool>("prefilter");
+        QTest::newRow("QRegularExpression") << false;
+        QTest::newRow("QLoguruRegex") << true;
+    }
+
+    void regexSearch()
+    {
+        QFETCH(bool, prefilter);
+
+        QLoguruStorage storage;
+        for (int i = 0; i < 1000000; ++i)
+            storage.append(makeEntry(i));
+
+        QString pattern("request 99.*ms");
+        QRegularExpression regex(pattern);
+        QLoguruRegex search(pattern, true);
+        QCOMPARE(search.requiredLiteral(), std::string("request 99"));
+
+        int matches = 0;
+        QBENCHMARK {
+            for (std::size_t row = 0; row < storage.size(); ++row) {
+                std::string_view message = storage.message(row);
+                if (prefilter)
+                    matches += search.matches(message);
+                else
+                    matches += regex
+                                   .match(QString::fromUtf8(
+                                       message.data(), message.size()
+                                   ))
+                                   .hasMatch();
+            }
+        }
+        QVERIFY(matches > 0);
+    }
+
+    void sortFilterProxyFilter()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        // The fixed string filtering QLoguru used to do, for comparison with
+        // proxyFilter.
+        QSortFilterProxyModel proxy;
+        proxy.setFilterKeyColumn(-1);
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilterFixedString("request 9");
+            proxy.setFilterFixedString("request 1");
+        }
+    }
+
+    void proxyFilter()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilter(QLoguruFilter("request 9", false, false));
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("request 1", false, true));
+            waitForFilter(proxy);
+        }
+    }
+
+    void proxyFilterSpilled()
+    {
+        // Only the last 64k rows stay in memory, the filter reads the others
+        // from the mapped files.
+        QTemporaryDir directory;
+        QLoguruModel model;
+        model.setSpillDirectory(directory.path());
+        model.setMemoryEntries(65536);
+        fillModel(model, 1000000);
+        QVERIFY(model.storage().spilledRows() > 0);
+        QVERIFY(model.storage().diskUsage() > 0);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilter(QLoguruFilter("request 9", false, false));
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("request 1", false, true));
+            waitForFilter(proxy);
+        }
+    }
+
+    void proxyFacets()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        // Show only the errors, then only one thread.
+        QLoguruProxyModel::Facets errors;
+        errors.hiddenLevels.fill(true);
+        errors.hiddenLevels[ QLoguruLevels::index(-2) ] = false;
+        QLoguruProxyModel::Facets thread;
+        thread.hiddenLoggers = { "main thread", "worker-1" };
+        QBENCHMARK {
+            proxy.setFacets(errors);
+            proxy.setFacets(thread);
+        }
+    }
+
+    void proxyFacetsToggle()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        // Hiding a level stores the two thirds of the rows left, showing
+        // everything again doesn't store any.
+        QLoguruProxyModel::Facets hidden;
+        hidden.hiddenLevels[ QLoguruLevels::index(-1) ] = true;
+        QBENCHMARK {
+            proxy.setFacets(hidden);
+            proxy.setFacets(QLoguruProxyModel::Facets());
+        }
+    }
+
+    void proxyFacetsFilter()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        // The scan only tests the messages of the rows of one thread.
+        QLoguruProxyModel::Facets thread;
+        thread.hiddenLoggers = { "main thread", "worker-1" };
+        proxy.setFacets(thread);
+        QBENCHMARK {
+            proxy.setFilter(QLoguruFilter("request 9", false, false));
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("request 1", false, true));
+            waitForFilter(proxy);
+        }
+    }
+
+    void proxyQuery()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        // A third of the rows are warnings, the message is only searched in
+        // those.
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilter(
+                QLoguruFilter("level>=warning msg:\"request 9\"", false, false)
+            );
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("logger=worker-2 line<10", false, true));
+            waitForFilter(proxy);
+        }
+    }
+
+    void proxyIndexedFilter()
+    {
+        QLoguruModel model;
+        model.setSearchIndexEnabled(true);
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+        QBENCHMARK {
+            proxy.setFilter(QLoguruFilter("request 99999", false, false));
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("request 12345 in", false, true));
+            waitForFilter(proxy);
+        }
+        QCOMPARE(proxy.rowCount(), 1);
+    }
+
+    void proxyRefine()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+
+        // Typing one character after the other, every step narrows.
+        QBENCHMARK {
+            proxy.setFilter(QLoguruFilter("req", false, false));
+            waitForFilter(proxy);
+            proxy.setFilter(QLoguruFilter("request 9", false, false));
+            proxy.setFilter(QLoguruFilter("request 99", false, false));
+            proxy.setFilter(QLoguruFilter("request 999", false, false));
+        }
+    }
+
+    void proxyAppend()
+    {
+        QLoguruModel model;
+        fillModel(model, 1000000);
+        model.setMaxEntries(1000000);
+
+        QLoguruProxyModel proxy;
+        proxy.setSourceModel(&model);
+        proxy.setFilter(QLoguruFilter("request 9", false, false));
+        waitForFilter(proxy);
+
+        // Appending evicts as many rows from the front, both should only
+        // cost as much as the batch.
+        int next = 1000000;
+        QBENCHMARK {
+            std::vector<QLoguruModel::entry_t> batch;
+            for (int i = 0; i < 1000; ++i)
+                batch.push_back(makeEntry(next++));
+            model.addEntries(batch);
+        }
+    }
+};
+
+QTEST_MAIN(QLoguruBenchmark);
+#include "bench_qloguru.moc"
@@ -1,7 +1,9 @@
 #include <QAction>
 #include <QComboBox>
+#include <QDateTime>
 #include <QDialog>
 #include <QDialogButtonBox>
+#include <QFile>
 #include <QHeaderView>
 #include <QLineEdit>
 #include <QMenu>
@@ -12,14 +14,25 @@
 #include <QScrollArea>
 #include <QScrollBar>
 #include <QSettings>
+#include <QTemporaryDir>
+#include <QSignalSpy>
 #include <QTest>
 #include <QTimer>
 #include <QTreeView>
+#include <QTreeWidget>
 #include <QCheckBox>
+#include <random>
 
 #include "qloguru/qabstract_loguru_toolbar.hpp"
 #include "qloguru/qloguru.hpp"
 #include "loguru.hpp"
+#include "qloguru_filter.hpp"
+#include "qloguru_filter_scheduler.hpp"
+#include "qloguru_model.hpp"
+#include "qloguru_query.hpp"
+#include "qloguru_regex.hpp"
+#include "qloguru_storage.hpp"
+#include "qloguru_substring_search.hpp"
 
 class QTestToolBar : public QAbstractLoguruToolBar
 {
@@ -111,6 +124,677 @@ private slots:
         QCOMPARE(widget.itemsCount(), 20);
     }
 
+    void ingestionBufferTest()
+    {
+        QLoguru widget;
+        widget.setBufferCapacity(16);
+        QCOMPARE(widget.getBufferCapacity(), 16);
+        widget.setOverflowPolicy(OverflowPolicy::OverflowPolicyDropNewest);
+        QCOMPARE(
+            widget.getOverflowPolicy(), OverflowPolicy::OverflowPolicyDropNewest
+        );
+        for (int i = 0; i < 100; i++)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 16);
+        QCOMPARE(widget.droppedCount(), 84);
+        QCOMPARE(widget.highWaterMark(), 16);
+
+        widget.clear();
+        widget.setOverflowPolicy(OverflowPolicy::OverflowPolicyDropOldest);
+        for (int i = 0; i < 100; i++)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 16);
+        QCOMPARE(widget.droppedCount(), 168);
+
+        widget.clear();
+        widget.setOverflowPolicy(OverflowPolicy::OverflowPolicyBlock);
+        for (int i = 0; i < 100; i++)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 100);
+        QCOMPARE(widget.droppedCount(), 168);
+    }
+
+    void spillDirectory()
+    {
+        QTemporaryDir directory;
+        QLoguru widget;
+        QCOMPARE(widget.getSpillDirectory(), QString());
+        widget.setSpillDirectory(directory.path());
+        widget.setMemoryEntries(4);
+        QCOMPARE(widget.getSpillDirectory(), directory.path());
+        QCOMPARE(widget.getMemoryEntries(), std::size_t(4));
+
+        for (int i = 0; i < 10; ++i)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 10);
+
+        widget.setSpillDirectory("");
+        QCOMPARE(widget.getSpillDirectory(), QString());
+        QCOMPARE(widget.itemsCount(), 10);
+    }
+
+    void spillSegments()
+    {
+        QTemporaryDir directory;
+        QLoguruStorage storage;
+        storage.setSegmentRows(4);
+        storage.setMemoryRows(4);
+        storage.setSpillDirectory(directory.path());
+
+        auto append = [ &storage ](int first, int count, bool wait) {
+            for (int i = first; i < first + count; ++i) {
+                storage.append(
+                    { i,
+                      i * 2,
+                      i % 3,
+                      "message " + std::to_string(i),
+                      "logger " + std::to_string(i % 2),
+                      "file.cpp",
+                      static_cast<unsigned>(i) }
+                );
+                if (wait) {
+                    storage.spill();
+                    storage.waitForSpill();
+                }
+            }
+        };
+        auto check = [ &storage ](int first) {
+            for (std::size_t row = 0; row < storage.size(); ++row) {
+                int i = first + static_cast<int>(row);
+                QCOMPARE(storage.time(row), std::int64_t(i));
+                QCOMPARE(storage.elapsed(row), std::int64_t(i * 2));
+                QCOMPARE(storage.level(row), i % 3);
+                QCOMPARE(storage.line(row), unsigned(i));
+                QCOMPARE(
+                    std::string(storage.message(row)),
+                    "message " + std::to_string(i)
+                );
+                QCOMPARE(
+                    std::string(storage.loggerName(storage.loggerId(row))),
+                    "logger " + std::to_string(i % 2)
+                );
+            }
+        };
+
+        append(0, 30, true);
+        QCOMPARE(storage.size(), std::size_t(30));
+        QCOMPARE(storage.spilledRows(), std::size_t(24));
+        QVERIFY(storage.diskUsage() > 0);
+        check(0);
+
+        // Evicting across segments, then into the rows in memory.
+        storage.popFront(10);
+        QCOMPARE(storage.spilledRows(), std::size_t(14));
+        check(10);
+        storage.popFront(16);
+        QCOMPARE(storage.spilledRows(), std::size_t(0));
+        QCOMPARE(storage.diskUsage(), std::size_t(0));
+        check(26);
+
+        // A large batch is spilled in as many segments as it takes, rows
+        // evicted while their segment is written aren't spilled.
+        append(30, 8, false);
+        storage.spill();
+        storage.popFront(2);
+        storage.waitForSpill();
+        QCOMPARE(storage.spilledRows(), std::size_t(6));
+        check(28);
+
+        // Stopping keeps the spilled rows.
+        storage.setSpillDirectory("");
+        append(38, 10, true);
+        QCOMPARE(storage.spilledRows(), std::size_t(6));
+        check(28);
+    }
+
+    void spillFailure()
+    {
+        // A directory that doesn't exist can't take a segment.
+        QTemporaryDir directory;
+        QString missing = directory.filePath("missing");
+        QLoguruModel model;
+        model.setSpillDirectory(missing);
+        model.setMemoryEntries(0);
+        QSignalSpy spy(&model, &QLoguruModel::spillFailed);
+
+        std::vector<QLoguruModel::entry_t> entries(
+            QLoguruSpillStore::defaultSegmentRows,
+            { 0, 0, loguru::Verbosity_INFO, "hello", "main", "main.cpp", 1 }
+        );
+        model.addEntries(entries);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toString(), missing);
+        QCOMPARE(model.getSpillDirectory(), QString());
+        QCOMPARE(model.storage().spilledRows(), std::size_t(0));
+        QCOMPARE(model.rowCount(), int(entries.size()));
+
+        // Not reported again, the rows simply stay in memory.
+        model.addEntries(entries);
+        QCOMPARE(spy.count(), 1);
+    }
+
+    void captureRoundTrip()
+    {
+        QTemporaryDir directory;
+        QString path = directory.filePath("test.capture");
+
+        QLoguru widget;
+        LOG_F(INFO, "first");
+        LOG_F(WARNING, "second");
+        QTest::qWait(100);
+        QVERIFY(widget.saveCapture(path));
+
+        widget.clear();
+        LOG_F(INFO, "replaced");
+        QTest::qWait(100);
+        QVERIFY(widget.loadCapture(path));
+        QCOMPARE(widget.itemsCount(), 2);
+
+        const QTreeView* treeView =
+            widget.findChild<const QTreeView*>("qloguruTreeView");
+        const QAbstractItemModel* model = treeView->model();
+        QCOMPARE(model->data(model->index(0, 0)).toString(), QString("Info"));
+        QCOMPARE(model->data(model->index(0, 4)).toString(), QString("first"));
+        QCOMPARE(
+            model->data(model->index(1, 0)).toString(), QString("Warning")
+        );
+        QCOMPARE(model->data(model->index(1, 4)).toString(), QString("second"));
+
+        widget.setMaxEntries(1);
+        QVERIFY(widget.loadCapture(path));
+        QCOMPARE(widget.itemsCount(), 1);
+        QCOMPARE(model->data(model->index(0, 4)).toString(), QString("second"));
+
+        QVERIFY(!widget.loadCapture(directory.filePath("missing.capture")));
+    }
+
+    void importLogFile()
+    {
+        QTemporaryDir directory;
+        QFile file(directory.filePath("test.log"));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(
+            "arguments: ./test\n"
+            "date       time         ( uptime  ) [ thread name/id ]"
+            "                   file:line     v| \n"
+            "2024-03-05 10:00:00.000 (   0.001s) [main thread     ]"
+            "            main.cpp:42      INFO| first\n"
+            "2024-03-05 10:00:00.100 (   0.101s) [worker          ]"
+            "          worker.cpp:7       WARN| second\n"
+            "on two lines\n"
+        );
+        file.close();
+
+        QLoguru widget;
+        QVERIFY(widget.importLogFile(file.fileName()));
+        QTRY_VERIFY(!widget.isImporting());
+        QCOMPARE(widget.itemsCount(), 2);
+
+        const QTreeView* treeView =
+            widget.findChild<const QTreeView*>("qloguruTreeView");
+        const QAbstractItemModel* model = treeView->model();
+        QCOMPARE(model->data(model->index(0, 0)).toString(), QString("Info"));
+        QCOMPARE(
+            model->data(model->index(0, 1)).toString(), QString("main thread")
+        );
+        QCOMPARE(model->data(model->index(0, 4)).toString(), QString("first"));
+        QCOMPARE(
+            model->data(model->index(1, 0)).toString(), QString("Warning")
+        );
+        QCOMPARE(
+            model->data(model->index(1, 4)).toString(),
+            QString("second\non two lines")
+        );
+        QCOMPARE(
+            model->data(model->index(1, 5)).toString(), QString("worker.cpp")
+        );
+        QCOMPARE(model->data(model->index(1, 6)).toInt(), 7);
+
+        QVERIFY(!widget.importLogFile(directory.filePath("missing.log")));
+    }
+
+    void customLevelNames()
+    {
+        loguru::set_verbosity_to_name_callback(
+            [](loguru::Verbosity verbosity) -> const char* {
+            return verbosity == loguru::Verbosity_WARNING ? "Careful" : nullptr;
+            }
+        );
+
+        QLoguru widget;
+        LOG_F(WARNING, "test");
+        LOG_F(INFO, "test");
+        QTest::qWait(100);
+
+        const QTreeView* treeView =
+            widget.findChild<const QTreeView*>("qloguruTreeView");
+        const QAbstractItemModel* model = treeView->model();
+        QCOMPARE(
+            model->data(model->index(0, 0)).toString(), QString("Careful")
+        );
+        QCOMPARE(model->data(model->index(1, 0)).toString(), QString("Info"));
+
+        loguru::set_verbosity_to_name_callback(nullptr);
+        widget.refreshLevelNames();
+        QCOMPARE(
+            model->data(model->index(0, 0)).toString(), QString("Warning")
+        );
+    }
+
+    void substringSearch()
+    {
+        auto contains = [](std::string_view needle,
+                           std::string_view haystack,
+                           bool isCaseSensitive = true) {
+            return QLoguruSubstringSearch(needle, isCaseSensitive)
+                .contains(haystack);
+        };
+
+        QVERIFY(contains("", ""));
+        QVERIFY(!contains("a", ""));
+        QVERIFY(contains("a", "a"));
+        QVERIFY(contains("ab", "xxab"));
+        QVERIFY(!contains("ab", "xxa"));
+        QVERIFY(!contains("abc", "ab"));
+
+        // Lengths 1, 2 and past a whole block, found at every offset of
+        // haystacks around the 16 and 32 byte blocks, the tails included.
+        for (std::size_t length : { 1, 2, 3, 16, 17, 31, 32, 33, 40 }) {
+            std::string needle;
+            for (std::size_t i = 0; i < length; ++i)
+                needle += static_cast<char>('a' + i % 26);
+
+            for (std::size_t size = length; size <= 80; ++size) {
+                for (std::size_t at = 0; at + length <= size; ++at) {
+                    std::string haystack(size, '.');
+                    haystack.replace(at, length, needle);
+                    QVERIFY(contains(needle, haystack));
+
+                    // Only the last byte differs.
+                    haystack[ at + length - 1 ] = '#';
+                    QVERIFY(!contains(needle, haystack));
+                }
+            }
+        }
+
+        // ASCII letters are folded, nothing else is.
+        QLoguruSubstringSearch folded("Hello World", false);
+        QVERIFY(folded.isAscii());
+        QVERIFY(folded.contains("say HELLO world!"));
+        QVERIFY(!contains("@", "`", false));
+        QVERIFY(!contains("[", "{", false));
+        QVERIFY(contains("\xc3\xa9t\xc3\xa9", "l'\xc3\xa9t\xc3\xa9"));
+        QVERIFY(!contains("\xc3\xa9t\xc3\xa9", "\xc3\x89T\xc3\x89"));
+        QVERIFY(!QLoguruSubstringSearch("\xc3\xa9t\xc3\xa9", false).isAscii());
+
+        // Random haystacks agree with QString, letters and a non-ASCII
+        // character in both cases.
+        static constexpr std::string_view alphabet[] = {
+            "a", "b", "A", "B", " ", "\xc3\xa9", "\xc3\x89"
+        };
+        std::mt19937 random(42);
+        for (int i = 0; i < 2000; ++i) {
+            std::string haystack;
+            int size = static_cast<int>(random() % 70);
+            for (int j = 0; j < size; ++j)
+                haystack += alphabet[ random() % std::size(alphabet) ];
+
+            std::string needle;
+            int length = 1 + static_cast<int>(random() % 4);
+            for (int j = 0; j < length; ++j)
+                needle += alphabet[ random() % 5 ];
+
+            QString text = QString::fromStdString(haystack);
+            QString word = QString::fromStdString(needle);
+            QCOMPARE(
+                contains(needle, haystack, true),
+                text.indexOf(word, 0, Qt::CaseSensitive) >= 0
+            );
+            QCOMPARE(
+                contains(needle, haystack, false),
+                text.indexOf(word, 0, Qt::CaseInsensitive) >= 0
+            );
+        }
+    }
+
+    void regexRequiredLiteral()
+    {
+        auto literal = [](const QString& pattern) {
+            return QLoguruRegex::requiredLiteral(pattern);
+        };
+
+        QCOMPARE(
+            literal("timeout after \\d+ ms"), std::string("timeout after ")
+        );
+        QCOMPARE(literal("x+yz"), std::string("yz"));
+        QCOMPARE(literal("^start.*end$"), std::string("start"));
+
+        // Alternations give up, unless they're within a group.
+        QCOMPARE(literal("connect|disconnect"), std::string());
+        QCOMPARE(literal("(dis)?connected"), std::string("connected"));
+        QCOMPARE(literal("(foo|bar)bazz"), std::string("bazz"));
+        QCOMPARE(literal("(?:ab)cd"), std::string("cd"));
+
+        // Optional atoms and groups split the literal.
+        QCOMPARE(literal("colou?r"), std::string("colo"));
+        QCOMPARE(literal("abc?def"), std::string("def"));
+        QCOMPARE(literal("abc{0,2}d"), std::string("ab"));
+        QCOMPARE(literal("request (id )?42"), std::string("request "));
+
+        // Classes aren't literals, their content isn't either.
+        QCOMPARE(literal("[abc]def"), std::string("def"));
+        QCOMPARE(literal("error[0-9]{3}code"), std::string("error"));
+        QCOMPARE(literal("[|(]xy"), std::string("xy"));
+
+        // Escaped punctuation is literal, classes and quoting aren't.
+        QCOMPARE(literal("a\\.b\\+c"), std::string("a.b+c"));
+        QCOMPARE(literal("\\d\\s\\w"), std::string());
+        QCOMPARE(literal("\\Qa.b\\E"), std::string());
+        QCOMPARE(literal("abc\\"), std::string());
+
+        // Inline options and lookarounds give up.
+        QCOMPARE(literal("(?i)abc"), std::string());
+        QCOMPARE(literal("(?=x)abc"), std::string());
+
+        QCOMPARE(
+            literal(QString::fromUtf8("\xc3\xa9t\xc3\xa9")),
+            std::string("\xc3\xa9t\xc3\xa9")
+        );
+
+        // Ignoring the case, only ASCII literals are kept.
+        QLoguruRegex ascii("Hello.*World", false);
+        QCOMPARE(ascii.requiredLiteral(), std::string("Hello"));
+        QVERIFY(ascii.matches(std::string_view("say hello, world")));
+        QVERIFY(!ascii.matches(std::string_view("say world, hello")));
+        QLoguruRegex accented(
+            QString::fromUtf8("\xc3\xa9t\xc3\xa9 \\d+"), false
+        );
+        QCOMPARE(accented.requiredLiteral(), std::string());
+        QVERIFY(accented.matches(std::string_view("\xc3\x89T\xc3\x89 2024")));
+    }
+
+    void searchIndexTest()
+    {
+        QLoguru widget;
+        QCOMPARE(widget.isSearchIndexEnabled(), false);
+        widget.setSearchIndexMemoryLimit(1 << 20);
+        QCOMPARE(widget.getSearchIndexMemoryLimit(), 1 << 20);
+        widget.setMaxEntries(50);
+        for (int i = 0; i < 100; i++)
+            LOG_F(INFO, "indexed %d", i);
+        QTest::qWait(100);
+        widget.setSearchIndexEnabled(true);
+        QCOMPARE(widget.isSearchIndexEnabled(), true);
+        for (int i = 100; i < 200; i++)
+            LOG_F(INFO, "indexed %d", i);
+        QTest::qWait(100);
+
+        QTestToolBar toolbar;
+        widget.registerToolbar(&toolbar);
+        toolbar.filter()->setText("indexed 19");
+        QCOMPARE(widget.itemsCount(), 10);
+        toolbar.filter()->setText("Indexed 1");
+        QCOMPARE(widget.itemsCount(), 50);
+        toolbar.regex()->trigger();
+        toolbar.filter()->setText("indexed 1[0-5]");
+        QCOMPARE(widget.itemsCount(), 10);
+        toolbar.filter()->setText("indexed 0");
+        QCOMPARE(widget.itemsCount(), 0);
+    }
+
+    void filterQueries()
+    {
+        QLoguru widget;
+        LOG_F(INFO, "connection timeout after 12 ms");
+        LOG_F(WARNING, "connection timeout after 300 ms");
+        LOG_F(ERROR, "disk full");
+        QTest::qWait(100);
+
+        QTestToolBar toolbar;
+        widget.registerToolbar(&toolbar);
+        QLineEdit* filter = toolbar.filter();
+        filter->setText("level>=warning");
+        QCOMPARE(widget.itemsCount(), 2);
+        filter->setText("level>=warning msg:timeout");
+        QCOMPARE(widget.itemsCount(), 1);
+        filter->setText("level<warning timeout");
+        QCOMPARE(widget.itemsCount(), 1);
+        filter->setText("lvl=error");
+        QCOMPARE(widget.itemsCount(), 1);
+        filter->setText("file:test_qloguru");
+        QCOMPARE(widget.itemsCount(), 3);
+        filter->setText("file!=test_qloguru.cpp");
+        QCOMPARE(widget.itemsCount(), 0);
+        filter->setText("line>0 msg:\"disk full\"");
+        QCOMPARE(widget.itemsCount(), 1);
+        // Malformed queries leave the current filter in place.
+        filter->setText("level>=bogus");
+        QCOMPARE(widget.itemsCount(), 1);
+        filter->setText("elapsed>=0s");
+        QCOMPARE(widget.itemsCount(), 3);
+        filter->setText("");
+        QCOMPARE(widget.itemsCount(), 3);
+    }
+
+    void filterNumbers()
+    {
+        QDateTime time(QDate(2024, 1, 15), QTime(13, 45, 12, 345));
+        QLoguruModel model;
+        model.addEntry(
+            { time.toMSecsSinceEpoch() * 1000000,
+              12500000000,
+              loguru::Verbosity_INFO,
+              "hello",
+              "main",
+              "main.cpp",
+              4242 }
+        );
+        QCOMPARE(model.index(0, 2).data().toString(), QString("13:45:12.345"));
+        QCOMPARE(model.index(0, 3).data().toString(), QString("12.500s"));
+
+        auto accepts = [ &model ](const QString& text, bool isRegex) {
+            return QLoguruFilter(text, isRegex, false).accepts(model, 0);
+        };
+        QVERIFY(accepts("13:45:12", false));
+        QVERIFY(accepts("12.345", false));
+        QVERIFY(accepts("12.500S", false));
+        QVERIFY(accepts("4242", false));
+        QVERIFY(!accepts("4243", false));
+        QVERIFY(!accepts("13:46", false));
+        QVERIFY(accepts("^13:4\\d:", true));
+        QVERIFY(!accepts("^45:", true));
+
+        // Only texts made of what numbers are shown with can match them.
+        QLoguruFilter word("hello", false, false);
+        word.prepare(model);
+        QVERIFY(!word.matchesAnyName());
+        QLoguruFilter number("42", false, false);
+        number.prepare(model);
+        QVERIFY(number.matchesAnyName());
+    }
+
+    void queryFreeText()
+    {
+        QLoguruModel model;
+        for (const char* message : { "a foo bar b", "bar then foo" }) {
+            model.addEntry(
+                { 0,
+                  0,
+                  loguru::Verbosity_ERROR,
+                  message,
+                  "main",
+                  "main.cpp",
+                  1 }
+            );
+        }
+
+        // The free terms around the predicates are searched as one text.
+        QLoguruQuery query("foo level>=error \"bar\"", false);
+        QCOMPARE(query.freeText(), QString("foo bar"));
+        QLoguruFilter filter("foo level>=error bar", false, false);
+        QVERIFY(filter.accepts(model, 0));
+        QVERIFY(!filter.accepts(model, 1));
+        QLoguruFilter plain("foo bar", false, false);
+        QVERIFY(plain.accepts(model, 0));
+        QVERIFY(!plain.accepts(model, 1));
+    }
+
+    void queryTimeOfDay()
+    {
+        // Same local time in winter and in summer, whatever the time zone
+        // and its daylight saving offset.
+        QLoguruModel model;
+        for (int month : { 1, 7 }) {
+            QDateTime time(QDate(2024, month, 15), QTime(13, 45, 12, 345));
+            model.addEntry(
+                { time.toMSecsSinceEpoch() * 1000000,
+                  0,
+                  loguru::Verbosity_INFO,
+                  "hello",
+                  "main",
+                  "main.cpp",
+                  1 }
+            );
+        }
+
+        QLoguruFilter within("time>=13:45 time<13:46", false, false);
+        QLoguruFilter before("time<13:45", false, false);
+        for (int row = 0; row < 2; ++row) {
+            QVERIFY(within.accepts(model, row));
+            QVERIFY(!before.accepts(model, row));
+        }
+    }
+
+    void facetsTest()
+    {
+        QLoguru widget;
+        LOG_F(INFO, "first");
+        LOG_F(INFO, "second");
+        LOG_F(WARNING, "third");
+        LOG_F(ERROR, "fourth");
+        QTest::qWait(100);
+
+        std::unique_ptr<QAbstractLoguruToolBar> toolbar(createToolBar());
+        widget.registerToolbar(toolbar.get());
+        QTreeWidget* tree = toolbar->facets();
+        QVERIFY(tree);
+
+        QTreeWidgetItem* levels = tree->topLevelItem(0);
+        QCOMPARE(levels->childCount(), 3);
+        QTreeWidgetItem* info = levels->child(2);
+        QCOMPARE(info->text(0), QString("Info"));
+        QCOMPARE(info->text(1), QString("2"));
+
+        info->setCheckState(0, Qt::Unchecked);
+        QCOMPARE(widget.itemsCount(), 2);
+        toolbar->filter()->setText("fourth");
+        QCOMPARE(widget.itemsCount(), 1);
+        toolbar->filter()->setText("");
+        info->setCheckState(0, Qt::Checked);
+        QCOMPARE(widget.itemsCount(), 4);
+
+        QTreeWidgetItem* threads = tree->topLevelItem(1);
+        QCOMPARE(threads->childCount(), 1);
+        QCOMPARE(threads->child(0)->text(1), QString("4"));
+        threads->child(0)->setCheckState(0, Qt::Unchecked);
+        QCOMPARE(widget.itemsCount(), 0);
+        LOG_F(INFO, "fifth");
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 0);
+        threads->child(0)->setCheckState(0, Qt::Checked);
+        QCOMPARE(widget.itemsCount(), 5);
+    }
+
+    void filterDelayTest()
+    {
+        QLoguru widget;
+        LOG_F(INFO, "first");
+        LOG_F(INFO, "second");
+        QTest::qWait(100);
+
+        QTestToolBar toolbar;
+        QCOMPARE(toolbar.getMaximumFilterDelay(), 300);
+        toolbar.setMaximumFilterDelay(0);
+        QCOMPARE(toolbar.getMaximumFilterDelay(), 0);
+        widget.registerToolbar(&toolbar);
+
+        toolbar.filter()->setText("first");
+        QCOMPARE(widget.itemsCount(), 1);
+        toolbar.caseSensitive()->trigger();
+        toolbar.filter()->setText("First");
+        QCOMPARE(widget.itemsCount(), 0);
+        toolbar.filter()->setText("first");
+        QCOMPARE(widget.itemsCount(), 1);
+    }
+
+    void filterBurstTest()
+    {
+        using Result = QLoguruFilterScheduler::Result;
+        std::vector<QString> applied;
+        Result result = Result::Running;
+        QLoguruFilterScheduler scheduler(
+            [ & ](const QLoguruFilterScheduler::settings_t& settings) {
+                applied.push_back(settings.text);
+                return result;
+            }
+        );
+
+        // Nothing is known about the cost yet, the first change applies
+        // right away and keeps running in the background.
+        scheduler.schedule({ "c", false, false });
+        QCOMPARE(applied.size(), std::size_t(1));
+        QTest::qWait(40);
+        QVERIFY(scheduler.currentDelay() > 0);
+        scheduler.finished();
+        QVERIFY(scheduler.currentDelay() > 0);
+
+        // The burst within the delay is applied once, with the last text.
+        result = Result::Applied;
+        scheduler.schedule({ "co", false, false });
+        scheduler.schedule({ "con", false, false });
+        scheduler.schedule({ "conn", false, false });
+        QCOMPARE(applied.size(), std::size_t(1));
+        QTRY_COMPARE(applied.size(), std::size_t(2));
+        QCOMPARE(applied.back(), QString("conn"));
+        QTest::qWait(scheduler.maximumDelay());
+        QCOMPARE(applied.size(), std::size_t(2));
+
+        // Applied synchronously, the cost was measured right away.
+        QCOMPARE(scheduler.currentDelay(), 0);
+
+        // Rejected settings aren't taken as applied, the same settings are
+        // applied again once they're accepted.
+        result = Result::Rejected;
+        scheduler.schedule({ "conn(", true, false });
+        QCOMPARE(applied.size(), std::size_t(3));
+        result = Result::Applied;
+        scheduler.schedule({ "conn(", true, false });
+        QCOMPARE(applied.size(), std::size_t(4));
+        scheduler.schedule({ "conn(", true, false });
+        QCOMPARE(applied.size(), std::size_t(4));
+    }
+
+    void filterMaximumDelay()
+    {
+        QLoguruFilterScheduler scheduler(
+            [](const QLoguruFilterScheduler::settings_t&) {
+                QTest::qSleep(20);
+                return QLoguruFilterScheduler::Result::Applied;
+            }
+        );
+        scheduler.schedule({ "c", false, false });
+
+        // Below the minimum delay, the maximum one still holds.
+        scheduler.setMaximumDelay(10);
+        QCOMPARE(scheduler.currentDelay(), 10);
+        scheduler.setMaximumDelay(0);
+        QCOMPARE(scheduler.currentDelay(), 0);
+    }
+
     void backgroundForegroundColorTest()
     {
         QLoguru widget;
@@ -129,6 +813,130 @@ private slots:
         QCOMPARE(widget.getLoggerForeground("test"), std::nullopt);
     }
 
+    void styleChangedRows()
+    {
+        QLoguru widget;
+        LOG_F(INFO, "first");
+        std::thread t([]() {
+            loguru::set_thread_name("styled");
+            LOG_F(INFO, "second");
+            LOG_F(INFO, "third");
+        });
+        t.join();
+        LOG_F(INFO, "fourth");
+        QTest::qWait(100);
+
+        // Only the rows of the styled thread are updated.
+        const QTreeView* treeView =
+            widget.findChild<const QTreeView*>("qloguruTreeView");
+        QSignalSpy spy(treeView->model(), &QAbstractItemModel::dataChanged);
+        widget.setLoggerBackground("styled", QBrush(Qt::red));
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy[ 0 ][ 0 ].value<QModelIndex>().row(), 1);
+        QCOMPARE(spy[ 0 ][ 1 ].value<QModelIndex>().row(), 2);
+
+        widget.setLoggerForeground("unused", Qt::white);
+        QCOMPARE(spy.count(), 1);
+    }
+
+    void styleChangedInterleaved()
+    {
+        // Two stretches of rows where "a" alternates with "b", separated by
+        // rows of "b" only.
+        std::vector<QLoguruModel::entry_t> entries;
+        for (int i = 0; i < 3300; ++i) {
+            bool isA = (i < 1500 || i >= 3000) && i % 3 == 0;
+            entries.push_back(
+                { 0, 0, 0, "message", isA ? "a" : "b", "main.cpp", 1 }
+            );
+        }
+        QLoguruModel model;
+        model.addEntries(entries);
+
+        // The 600 runs of "a" are merged across the smallest gaps, never
+        // across the rows of "b" only.
+        QSignalSpy spy(&model, &QAbstractItemModel::dataChanged);
+        model.setLoggerBackground("a", QBrush(Qt::red));
+        QCOMPARE(spy.count(), 256);
+
+        int previous = -1;
+        std::vector<bool> isReported(entries.size(), false);
+        for (const QList<QVariant>& arguments : spy) {
+            int first = arguments[ 0 ].value<QModelIndex>().row();
+            int last = arguments[ 1 ].value<QModelIndex>().row();
+            QVERIFY(first > previous);
+            QVERIFY(last < 1500 || first >= 3000);
+            for (int row = first; row <= last; ++row)
+                isReported[ row ] = true;
+            previous = last;
+        }
+        for (std::size_t row = 0; row < entries.size(); ++row) {
+            if (entries[ row ].loggerName == "a")
+                QVERIFY(isReported[ row ]);
+        }
+    }
+
+    void styleRules()
+    {
+        QLoguru widget;
+        LOG_F(INFO, "first");
+        LOG_F(ERROR, "missed the deadline");
+        QTest::qWait(100);
+
+        QFont bold;
+        bold.setBold(true);
+        std::vector<QLoguruStyleRule> rules = {
+            { "level=error", QBrush(Qt::red), std::nullopt, std::nullopt },
+            { "msg:deadline", std::nullopt, std::nullopt, bold },
+            { "level>=bogus", QBrush(Qt::blue), std::nullopt, std::nullopt },
+        };
+        widget.setStyleRules(rules);
+        QVERIFY(widget.getStyleRules() == rules);
+
+        // Rules apply to the messages logged afterwards too.
+        LOG_F(INFO, "deadline ahead");
+        QTest::qWait(100);
+
+        const QTreeView* treeView =
+            widget.findChild<const QTreeView*>("qloguruTreeView");
+        const QAbstractItemModel* model = treeView->model();
+        QCOMPARE(model->data(model->index(0, 0), Qt::BackgroundRole), QVariant());
+        QCOMPARE(
+            model->data(model->index(1, 0), Qt::BackgroundRole).value<QBrush>(),
+            QBrush(Qt::red)
+        );
+        // The first matching rule wins.
+        QCOMPARE(model->data(model->index(1, 0), Qt::FontRole), QVariant());
+        QCOMPARE(
+            model->data(model->index(2, 0), Qt::FontRole).value<QFont>(), bold
+        );
+
+        // Rules take precedence over the logger style, both rows were logged
+        // by the same thread.
+        QCOMPARE(
+            model->data(model->index(0, 1)), model->data(model->index(1, 1))
+        );
+        widget.setLoggerBackground(
+            model->data(model->index(1, 1)).toString().toStdString(),
+            QBrush(Qt::green)
+        );
+        QCOMPARE(
+            model->data(model->index(1, 0), Qt::BackgroundRole).value<QBrush>(),
+            QBrush(Qt::red)
+        );
+        QCOMPARE(
+            model->data(model->index(0, 0), Qt::BackgroundRole).value<QBrush>(),
+            QBrush(Qt::green)
+        );
+
+        widget.setStyleRules({});
+        QCOMPARE(
+            model->data(model->index(1, 0), Qt::BackgroundRole).value<QBrush>(),
+            QBrush(Qt::green)
+        );
+        QCOMPARE(model->data(model->index(2, 0), Qt::FontRole), QVariant());
+    }
+
     void fontTest()
     {
         QLoguru widget;
@@ -350,7 +1158,7 @@ private slots:
         QLoguru widget;
         QTreeView* treeView = widget.findChild<QTreeView*>("qloguruTreeView");
         QHeaderView* headerView = treeView->header();
-        QCOMPARE(headerView->count(), 5);
+        QCOMPARE(headerView->count(), 7);
         QMetaObject::invokeMethod(
             headerView,
             [] {
@@ -369,7 +1177,7 @@ private slots:
             },
             Qt::QueuedConnection);
         headerView->customContextMenuRequested(QPoint(5, 5));
-        QCOMPARE(headerView->count(), 5);
+        QCOMPARE(headerView->count(), 7);
         QCOMPARE(headerView->hiddenSectionCount(), 1);
         QMetaObject::invokeMethod(
             headerView,
@@ -389,7 +1197,7 @@ private slots:
             },
             Qt::QueuedConnection);
         headerView->customContextMenuRequested(QPoint(5, 5));
-        QCOMPARE(headerView->count(), 5);
+        QCOMPARE(headerView->count(), 7);
         QCOMPARE(headerView->hiddenSectionCount(), 2);
         QMetaObject::invokeMethod(
             headerView,
@@ -409,10 +1217,70 @@ private slots:
             },
             Qt::QueuedConnection);
         headerView->customContextMenuRequested(QPoint(5, 5));
-        QCOMPARE(headerView->count(), 5);
+        QCOMPARE(headerView->count(), 7);
         QCOMPARE(headerView->hiddenSectionCount(), 1);
     }
 
+    void lightweightView()
+    {
+        QLoguru widget;
+        QVERIFY(!widget.isLightweightViewEnabled());
+        QTreeView* treeView = widget.findChild<QTreeView*>("qloguruTreeView");
+        treeView->header()->setSectionHidden(2, true);
+
+        widget.setLightweightViewEnabled(true);
+        QVERIFY(widget.isLightweightViewEnabled());
+        QVERIFY(treeView->isHidden());
+        auto logView = widget.findChild<QAbstractScrollArea*>("qloguruLogView");
+        QVERIFY(logView);
+        QScrollBar* scrollBar = logView->verticalScrollBar();
+        logView->resize(100, 100);
+
+        widget.setAutoScrollPolicy(AutoScrollPolicy::AutoScrollPolicyEnabled);
+        for (int i = 0; i < 20; ++i)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(100);
+        QCOMPARE(widget.itemsCount(), 20);
+        QVERIFY(scrollBar->maximum() > 0);
+        QCOMPARE(scrollBar->value(), scrollBar->maximum());
+
+        widget.setLightweightViewEnabled(false);
+        QVERIFY(!widget.isLightweightViewEnabled());
+        QCOMPARE(treeView->model()->rowCount(), 20);
+        QCOMPARE(treeView->header()->count(), 7);
+        QVERIFY(treeView->header()->isSectionHidden(2));
+    }
+
+    void performanceMode()
+    {
+        QLoguru widget;
+        QTreeView* treeView = widget.findChild<QTreeView*>("qloguruTreeView");
+        QVERIFY(!widget.isPerformanceModeEnabled());
+        widget.setPerformanceModeEnabled(true);
+        QVERIFY(widget.isPerformanceModeEnabled());
+        QVERIFY(treeView->uniformRowHeights());
+
+        for (int i = 0; i < 20; ++i)
+            LOG_F(INFO, "test %d", i);
+        QTest::qWait(300);
+
+        // Every column but the stretched last one fits its contents.
+        const QAbstractItemModel* model = treeView->model();
+        QHeaderView* header = treeView->header();
+        for (int row = 0; row < model->rowCount(); ++row) {
+            for (int column = 0; column < header->count() - 1; ++column) {
+                QVERIFY(
+                    header->sectionSize(column) >=
+                    treeView->sizeHintForIndex(model->index(row, column))
+                        .width()
+                );
+            }
+        }
+
+        widget.setPerformanceModeEnabled(false);
+        QVERIFY(!treeView->uniformRowHeights());
+    }
+
     void setStyleFromToolbar()
     {
         QLoguru widget;